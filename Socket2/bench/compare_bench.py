@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+					SOCKET
+					 v3.02
+
+					bench/compare_bench.py
+
+
+Compares the results of run_bench.py with a stored baseline, and flags every
+time which is more than --threshold (a fraction; default 0.10) slower than in
+the baseline: the total of each structure, each of its stages, and the two
+throughputs. Times below --floor seconds (default 0.005) in both are left out,
+as they are mostly noise. The work counts are compared too: if they differ, the
+program's behaviour has changed, not just its speed, and the times are not
+comparable, so that structure is a failure too, unless --ignore-counts is given
+(for a change meant to do different work, until a new baseline is stored).
+
+Exits with status 1 if anything has regressed, or done different work, so that
+it can gate a build.
+
+usage: compare_bench.py <baseline.json> <results.json> [--threshold <fraction>]
+	[--floor <seconds>] [--ignore-counts]
+"""
+
+import argparse
+import json
+import sys
+
+
+def slower(name, before, after, args, regressions, floor=None):
+	if (before is None) or (after is None):
+		return
+	if max(before, after) < (args.floor if floor is None else floor):
+		return
+	change = (after - before) / before if before > 0 else float("inf")
+	flag = change > args.threshold
+	print("%s %-32s %10.4g -> %10.4g  %+7.1f%%" % ("REGRESSION" if flag else "          ",
+		name, before, after, 100.0 * change))
+	if flag:
+		regressions.append(name)
+
+
+def main():
+	parser = argparse.ArgumentParser(description="compare socket2 benchmark results")
+	parser.add_argument("baseline")
+	parser.add_argument("results")
+	parser.add_argument("--threshold", type=float, default=0.10)
+	parser.add_argument("--floor", type=float, default=0.005)
+	parser.add_argument("--ignore-counts", action="store_true",
+		help="do not fail on structures whose work counts differ")
+	args = parser.parse_args()
+
+	with open(args.baseline) as f:
+		baseline = json.load(f)
+	with open(args.results) as f:
+		results = json.load(f)
+
+	regressions = []
+	changed = []
+	before = dict((r["name"], r) for r in baseline["structures"])
+	for record in results["structures"]:
+		name = record["name"]
+		if name not in before:
+			print("           %-32s not in the baseline" % name)
+			continue
+		if record["counts"] != before[name]["counts"]:
+			changed.append(name)
+			print("CHANGED    %-32s work counts differ from the baseline" % name)
+			continue
+		slower(name + " total", before[name]["total"], record["total"], args, regressions)
+		for stage, seconds in record["stages"].items():
+			slower(name + " " + stage, before[name]["stages"].get(stage), seconds, args,
+				regressions)
+
+	# throughputs regress by falling, so compare their reciprocals, whatever
+	# their size
+	for key in ("structures_per_second", "residue_pairs_per_second"):
+		b = baseline["throughput"].get(key)
+		a = results["throughput"].get(key)
+		if b and a:
+			slower("1/" + key, 1.0 / b, 1.0 / a, args, regressions, 0.0)
+
+	if changed:
+		print("%d structures did their work differently from the baseline%s" % (len(changed),
+			" (ignored: --ignore-counts)" if args.ignore_counts else ""))
+	if regressions:
+		print("%d regressions beyond %.0f%%" % (len(regressions), 100.0 * args.threshold))
+	else:
+		print("no regressions beyond %.0f%%" % (100.0 * args.threshold))
+	sys.exit(1 if regressions or (changed and not args.ignore_counts) else 0)
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+					SOCKET
+					 v3.02
+
+					bench/compare_profiles.py
+
+
+Compares the results of run_bench.py for several builds of socket2 (the build
+profiles of the Makefile; 'make bench-profiles'), and records the speedup of
+each over the first (the ordinary, unoptimized build): of the total time of
+each structure, of the whole corpus, and of the contacts stage (the contact
+search of the knobs-into-holes search), which dominates on large structures.
+The work counts must be the same for every build, as they do the same work;
+any which differ are reported, and their speedups are not to be trusted.
+
+The speedups are printed, and written with the times to --out as JSON.
+
+usage: compare_profiles.py --out <json> <name>=<results.json> ...
+"""
+
+import argparse
+import json
+import platform
+import sys
+import time
+
+
+def main():
+	parser = argparse.ArgumentParser(description="compare socket2 build profiles")
+	parser.add_argument("--out", required=True)
+	parser.add_argument("profiles", nargs="+", metavar="name=results.json")
+	args = parser.parse_args()
+
+	profiles = []
+	for profile in args.profiles:
+		name, path = profile.split("=", 1)
+		with open(path) as f:
+			profiles.append((name, json.load(f)))
+
+	reference_name, reference = profiles[0]
+	before = dict((r["name"], r) for r in reference["structures"])
+	changed = 0
+	records = []
+	print("%-10s %12s %8s %12s %8s" % ("profile", "total (s)", "speedup", "contacts (s)", "speedup"))
+	for name, results in profiles:
+		structures = {}
+		total = contacts = reference_total = reference_contacts = 0.0
+		for record in results["structures"]:
+			if record["name"] not in before:
+				continue
+			was = before[record["name"]]
+			if record["counts"] != was["counts"]:
+				changed += 1
+				print("CHANGED    %s %s: work counts differ from %s" % (name, record["name"],
+					reference_name))
+			structures[record["name"]] = {
+				"total": record["total"],
+				"speedup": was["total"] / record["total"] if record["total"] else None}
+			total += record["total"]
+			contacts += record["stages"]["contacts"]
+			reference_total += was["total"]
+			reference_contacts += was["stages"]["contacts"]
+		speedup = reference_total / total if total else None
+		contacts_speedup = reference_contacts / contacts if contacts else None
+		records.append({"name": name, "total": total, "speedup": speedup,
+			"contacts": contacts, "contacts_speedup": contacts_speedup, "structures": structures})
+		print("%-10s %12.6f %8.2f %12.6f %8.2f" % (name, total, speedup or 0, contacts,
+			contacts_speedup or 0))
+
+	with open(args.out, "w") as out:
+		json.dump({"machine": platform.node(), "platform": platform.platform(),
+			"date": time.strftime("%Y-%m-%dT%H:%M:%S"), "reference": reference_name,
+			"profiles": records}, out, indent=1)
+		out.write("\n")
+	print("speedups over %s written to %s" % (reference_name, args.out))
+	sys.exit(1 if changed else 0)
+
+
+if __name__ == "__main__":
+	main()
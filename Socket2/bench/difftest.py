@@ -0,0 +1,339 @@
+#!/usr/bin/env python3
+"""
+					SOCKET
+					 v3.02
+
+					bench/difftest.py
+
+
+The differential test ('make difftest'): runs socket2 with its usual engines,
+and again with the legacy ones (--legacy; see legacy.c), over a corpus, and
+checks that the results are identical. The results are compared as data, from
+the JSON documents (-J; see json.c), not as text, item by item, each item
+whole (every field, to the last digit printed):
+
+	knobs		each knob: residue, hole, knobtype, order, complementary
+			knobs and geometry, in knob-key order
+	daisy_chains	each daisy chain: its knobs and coiled coil
+	coiled_coils	each true coiled coil: helices and their extents,
+			orientation, order and lengths
+	registers	the heptad registers of each residue in a coiled coil
+
+For each structure which differs, the first divergence is reported, with the
+items either side of it, from both runs.
+
+The corpus is any PDB files given (each with a DSSP file of the same name but
+for .dssp), those in bench/corpus, and --random synthetic structures made by
+ccgen with random oligomeric state, orientation, helix length, number of
+bundles, supercoil radius and coordinate noise (reproducibly, from --seed).
+Each is run at each of the --cutoffs.
+
+That checks only that the optimized engines agree with their unoptimized forms:
+an error common to both is not caught (see bench/holecheck.py). So, given
+--baseline, a socket2 built from the original program (the baseline commit;
+see the Makefile, bench/baseline-socket2), each structure is run by it too, and
+the results are compared from the long output files (-o), which both write:
+
+	helices		each helix: chain, extent, cutoff and number of knobs
+	residues	each residue of a helix, in order
+	knobs		each knob: its residue, partner helix, packing angle,
+			hole residues and sides
+
+and, if both find the same daisy chains and coiled coils, in the same order
+(from which they are derived):
+
+	knob types	each knob's type (a knob in a daisy chain is made a
+			proper knob), and the tally of each helix's knobs by type
+	registers	the heptad registers of each residue
+
+These must be the same, with the intended changes to the program left out:
+
+	- the 4 hole distances of a knob, which the original program
+	  printed against the wrong hole residues (user-038)
+	- the daisy chains and coiled coils and, through them, the knob
+	  types and registers (and the labels of the holes, from the
+	  registers): the original tracer misses some daisy chains,
+	  misreads others and finds them in another order (user-026), and
+	  its frequencies count chains of larger coiled coils (user-027);
+	  a run whose daisy chains or coiled coils differ is reported, but
+	  is not a failure (see bench/ordercheck.py for the check of the
+	  new count)
+	- what the original program prints on its standard output, apart
+	  from its daisy chains and coiled coils, and the runs which it
+	  does not complete (e.g. where its tracer gives up on a daisy
+	  chain)
+
+Exits with status 1 if any structure differs.
+
+usage: difftest.py --socket <socket2> --ccgen <ccgen> --work <dir>
+	[--random <n>] [--seed <n>] [--cutoffs <c,c,...>] [--baseline <socket2>]
+	[<PDB file> ...]
+"""
+
+import argparse
+import collections
+import glob
+import json
+import math
+import os
+import random
+import re
+import subprocess
+import sys
+
+
+DAISY_CHAIN = re.compile(r"^daisy chain\s+\d+ : knobs (.*)$")
+COILED_COIL = re.compile(r"^coiled coil\s+(\d+):\s+\d+ helices\s+([\d ]+?)\s+frequency")
+
+# a residue of the long output file: the residue, its registers, and its knob
+RESIDUE = re.compile(r"^\S+ (\w{3}\s+-?\d+:. iCode='.')(.*?)( T\d.*)?$")
+
+# a knob: knob type, partner helix, packing angle, hole chain, hole residues
+# and sides; the labels of the hole (e.g. (dgad)) are taken from the registers
+KNOB = re.compile(r"^ T(\d) H\s*(\d+):\s*(\S+) ; (?:hole \([^)]*\) )*chain (.):(.*); sides (.*)$")
+
+# a hole residue: the distance which follows it is left out
+HOLE_RESIDUE = re.compile(r"\((\d)\) (\w{3}\s+-?\d+'.')\s+\S+")
+
+
+def synthetic(args):
+	"""the (name, pdb, dssp) of --random structures from ccgen"""
+	rng = random.Random(args.seed)
+	structures = []
+	for i in range(args.random):
+		n = rng.randint(2, 6)
+		ccgen_args = ["-n", str(n), "-l", str(rng.randint(14, 50)),
+			"-b", str(rng.randint(1, 6)), "-j", "%.2f" % rng.uniform(0.0, 1.2),
+			"-s", str(rng.randint(1, 1000000))]
+		if rng.random() < 0.4:
+			ccgen_args.append("-a")
+		if rng.random() < 0.3:
+			# squeeze or loosen the bundle, from the usual 9.8 A between helices
+			spacing = rng.uniform(8.0, 11.5)
+			ccgen_args += ["-R", "%.2f" % (spacing / (2.0 * math.sin(math.pi / n)))]
+		prefix = os.path.join(args.work, "random_%d" % i)
+		subprocess.run([args.ccgen, "-o", prefix] + ccgen_args, check=True,
+			stdout=subprocess.DEVNULL)
+		structures.append(("random_%d (ccgen %s)" % (i, " ".join(ccgen_args)),
+			prefix + ".pdb", prefix + ".dssp"))
+	return structures
+
+
+def given(args):
+	"""the (name, pdb, dssp) of the PDB files given, and those in bench/corpus"""
+	pdbs = list(args.pdb)
+	bundled = os.path.join(os.path.dirname(os.path.abspath(__file__)), "corpus")
+	pdbs += sorted(glob.glob(os.path.join(bundled, "*.pdb")))
+	structures = []
+	for pdb in pdbs:
+		dssp = os.path.splitext(pdb)[0] + ".dssp"
+		if not os.path.exists(dssp):
+			sys.exit("difftest: %s has no DSSP file %s" % (pdb, dssp))
+		structures.append((os.path.basename(pdb), pdb, dssp))
+	return structures
+
+
+def run(args, pdb, dssp, cutoff, legacy):
+	"""the JSON results of socket2, with or without --legacy"""
+	out = os.path.join(args.work, "legacy.json" if legacy else "new.json")
+	command = [args.socket, "-f", os.path.abspath(pdb), "-s", os.path.abspath(dssp),
+		"-c", cutoff, "-q", "-J", out] + (["--legacy"] if legacy else [])
+	result = subprocess.run(command, stdout=subprocess.PIPE, universal_newlines=True,
+		cwd=args.work)
+	if result.returncode:
+		# the last line of output says why, if there is one
+		return None, (result.stdout.strip().splitlines()[-1:] or
+			["exit status %d" % result.returncode])
+	with open(out) as f:
+		return json.load(f), None
+
+
+def residue_label(results, r):
+	residue = results["residues"][r]
+	return "%s%d:%s" % (residue["name"], residue["number"], residue["chain"])
+
+
+def extract(results):
+	"""the results to be compared, as lists of (label, value), section by
+	section; the labels name each item for a human"""
+	knobs = [("knob %d (%s)" % (k["id"], residue_label(results, k["residue"])), k)
+		for k in results["knobs"]]
+	daisy_chains = [("daisy chain %d" % d["id"], d) for d in results["daisy_chains"]]
+	coiled_coils = [("coiled coil %d" % c["number"], c) for c in results["coiled_coils"]]
+	registers = [("residue %d (%s)" % (r["id"], residue_label(results, r["id"])),
+		r["registers"]) for r in results["residues"] if r["registers"]]
+	return [("knobs", knobs), ("daisy_chains", daisy_chains),
+		("coiled_coils", coiled_coils), ("registers", registers)]
+
+
+def run_baseline(args, socket, pdb, dssp, cutoff, name):
+	"""the standard output and the lines of the long output file of socket2,
+	or the error"""
+	out = os.path.join(args.work, name + ".long")
+	if os.path.exists(out):
+		os.remove(out)
+	result = subprocess.run([socket, "-f", os.path.abspath(pdb), "-s",
+		os.path.abspath(dssp), "-c", cutoff, "-o", out], stdout=subprocess.PIPE,
+		universal_newlines=True, errors="replace", cwd=args.work)
+	if result.returncode or not os.path.exists(out):
+		return None, None, (result.stdout.strip().splitlines()[-1:] or
+			["exit status %d" % result.returncode])
+	with open(out, errors="replace") as f:
+		return result.stdout, f.read().splitlines(), None
+
+
+def knob_fields(text):
+	"""the fields of a knob, from the rest of its line, and its type"""
+	m = KNOB.match(text)
+	if not m:
+		return {"unread": text}, None
+	return {"helix": int(m.group(2)), "angle": m.group(3), "hole_chain": m.group(4),
+		"hole": [" ".join(r) for r in HOLE_RESIDUE.findall(m.group(5))],
+		"sides": m.group(6)}, int(m.group(1))
+
+
+def extract_long(stdout, lines):
+	"""the daisy chains and coiled coils (from the standard output), and the
+	results to be compared, as lists of (label, value), section by section"""
+	daisy_chains = [m.group(1).split() for m in
+		(DAISY_CHAIN.match(line) for line in stdout.splitlines()) if m]
+	coiled_coils = [m.group(2).split() for m in
+		(COILED_COIL.match(line) for line in stdout.splitlines()) if m]
+	helices, residues, knobs, knob_types, registers = [], [], [], [], []
+	for line in lines[1:]:
+		fields = line.split(None, 1)
+		if (len(fields) == 2) and fields[1].startswith("helix"):
+			# the tally by type follows the number of knobs
+			helix, _, tally = fields[1].partition(" knobs, ")
+			label = "helix %d" % len(helices)
+			helices.append((label, helix))
+			knob_types.append((label, tally))
+			continue
+		m = RESIDUE.match(line)
+		if not m:
+			continue
+		residues.append(("residue %d" % len(residues), m.group(1)))
+		registers.append((m.group(1), m.group(2).strip()))
+		if m.group(3):
+			label = "knob %d (%s)" % (len(knobs), m.group(1))
+			knob, knobtype = knob_fields(m.group(3))
+			knobs.append((label, knob))
+			knob_types.append((label, knobtype))
+	return (daisy_chains, coiled_coils), [("helices", helices), ("residues", residues),
+		("knobs", knobs)], [("knob types", knob_types), ("registers", registers)]
+
+
+def first_divergence(new, old, names=("usual ", "legacy")):
+	"""a report of the first difference between the two results (each a list
+	of sections), or None"""
+	for (section, a), (_, b) in zip(new, old):
+		for i in range(max(len(a), len(b))):
+			if (i < len(a)) and (i < len(b)) and (a[i] == b[i]):
+				continue
+			lines = ["first divergence in %s, item %d of %d (%s) / %d (%s):" % (
+				section, i, len(a), names[0].strip(), len(b), names[1].strip())]
+			if (i < len(a)) and (i < len(b)) and isinstance(a[i][1], dict):
+				lines.append("  fields which differ: %s" % ", ".join(key for key in a[i][1]
+					if a[i][1].get(key) != b[i][1].get(key)))
+			for name, items in ((names[0], a), (names[1], b)):
+				for j in range(max(0, i - 2), min(len(items), i + 3)):
+					lines.append("  %s %s %-28s %s" % ("=>" if j == i else "  ", name,
+						items[j][0], json.dumps(items[j][1])))
+				if i >= len(items):
+					lines.append("  => %s (no such item)" % name)
+			return "\n".join(lines)
+	return None
+
+
+def compare_baseline(args, name, pdb, dssp, cutoff):
+	"""compares socket2 with the baseline socket2 on one structure: 'same',
+	'coiled coils' (the same but for the daisy chains or coiled coils, an
+	intended change),
+	'not run' (by the baseline), or 'differs'"""
+	stdout, lines, error = run_baseline(args, args.socket, pdb, dssp, cutoff, "new")
+	old_stdout, old_lines, old_error = run_baseline(args, args.baseline, pdb, dssp,
+		cutoff, "baseline")
+	if old_error:
+		print("not run %s -c %s by the baseline: %s" % (name, cutoff, old_error[0]))
+		return "not run"
+	if error:
+		print("DIFFERS %s -c %s: usual %s, baseline succeeded" % (name, cutoff, error[0]))
+		return "differs"
+
+	found, new, derived = extract_long(stdout, lines)
+	old_found, old, old_derived = extract_long(old_stdout, old_lines)
+	same_coiled_coils = found == old_found
+	if same_coiled_coils:
+		new, old = new + derived, old + old_derived
+	report = first_divergence(new, old, ("usual   ", "baseline"))
+	if report:
+		print("DIFFERS %s -c %s from the baseline\n%s" % (name, cutoff, report))
+		return "differs"
+	if not same_coiled_coils:
+		print("same    %s -c %s as the baseline, but for the daisy chains and coiled "
+			"coils: %d and %d, %d and %d in the baseline" % (name, cutoff, len(found[0]),
+			len(found[1]), len(old_found[0]), len(old_found[1])))
+		return "coiled coils"
+	print("same    %s -c %s as the baseline: %d knobs, %d daisy chains, %d coiled coils" % (
+		name, cutoff, len(new[2][1]), len(found[0]), len(found[1])))
+	return "same"
+
+
+def main():
+	parser = argparse.ArgumentParser(description="check socket2 against its unoptimized engines")
+	parser.add_argument("--socket", required=True)
+	parser.add_argument("--ccgen")
+	parser.add_argument("--work", required=True)
+	parser.add_argument("--random", type=int, default=0)
+	parser.add_argument("--seed", type=int, default=1)
+	parser.add_argument("--cutoffs", default="7.0,8.5")
+	parser.add_argument("--baseline")
+	parser.add_argument("pdb", nargs="*")
+	args = parser.parse_args()
+	args.socket = os.path.abspath(args.socket)
+	if args.baseline:
+		args.baseline = os.path.abspath(args.baseline)
+	args.work = os.path.abspath(args.work)
+	os.makedirs(args.work, exist_ok=True)
+	if args.random:
+		if not args.ccgen:
+			sys.exit("difftest: --random needs --ccgen")
+		args.ccgen = os.path.abspath(args.ccgen)
+
+	structures = given(args) + (synthetic(args) if args.random else [])
+	runs = differ = 0
+	against_baseline = collections.Counter()
+	for name, pdb, dssp in structures:
+		for cutoff in args.cutoffs.split(","):
+			new, new_error = run(args, pdb, dssp, cutoff, False)
+			legacy, legacy_error = run(args, pdb, dssp, cutoff, True)
+			runs += 1
+			if new_error or legacy_error:
+				# both must fail alike (e.g. on a limit of preproc.h)
+				if new_error != legacy_error:
+					differ += 1
+					print("DIFFERS %s -c %s: usual %s, legacy %s" % (name, cutoff,
+						new_error or "succeeded", legacy_error or "succeeded"))
+				continue
+			report = first_divergence(extract(new), extract(legacy))
+			if report:
+				differ += 1
+				print("DIFFERS %s -c %s\n%s" % (name, cutoff, report))
+			else:
+				print("same    %s -c %s: %d knobs, %d daisy chains, %d coiled coils" % (
+					name, cutoff, len(new["knobs"]), len(new["daisy_chains"]),
+					len(new["coiled_coils"])))
+			if args.baseline:
+				against_baseline[compare_baseline(args, name, pdb, dssp, cutoff)] += 1
+
+	print("%d of %d runs differ" % (differ, runs))
+	if args.baseline:
+		print("against the baseline: %d of %d runs differ; %d differ only in their "
+			"daisy chains and coiled coils (intended), %d not run by the baseline" % (
+			against_baseline["differs"], runs, against_baseline["coiled coils"],
+			against_baseline["not run"]))
+	sys.exit(1 if differ or against_baseline["differs"] else 0)
+
+
+if __name__ == "__main__":
+	main()
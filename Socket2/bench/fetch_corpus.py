@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+					SOCKET
+					 v3.02
+
+					bench/fetch_corpus.py
+
+
+Fetches the real structures of the benchmark corpus into bench/corpus ('make
+corpus'), as <name>.pdb and <name>.dssp, where run_bench.py, difftest.py,
+holecheck.py and ordercheck.py pick them up beside the structures made by
+ccgen. Each is downloaded from the RCSB and given a DSSP file as in
+socket2_colab.ipynb: the coordinate records are kept, after a HEADER and a
+CRYST1 record (which mkdssp wants), mkdssp is run on the file, and the DSSP
+lines are cut to 136 characters (which read_dssp() expects).
+
+	2zta	GCN4 leucine zipper, a parallel dimer
+	1gcm	GCN4-pII, a parallel trimer
+	1aik	HIV-1 gp41 core, a trimer of hairpins
+	1ebo	Ebola GP2 core, a trimer of hairpins
+	1bg1	STAT3B on DNA, the coiled coil domain of a larger protein
+	1cii	colicin Ia, long antiparallel helices
+
+1aik, 1ebo and 1bg1 are the structures of the comments in daisies.c and
+knobs.c. A structure already in bench/corpus is left as it is.
+
+Needs network access and mkdssp (the dssp package). Exits with status 1 if
+any structure cannot be fetched.
+
+usage: fetch_corpus.py [--corpus <dir>] [--mkdssp <mkdssp>] [<code> ...]
+"""
+
+import argparse
+import gzip
+import os
+import subprocess
+import sys
+import urllib.error
+import urllib.request
+
+
+CODES = ["2zta", "1gcm", "1aik", "1ebo", "1bg1", "1cii"]
+
+URL = "https://files.rcsb.org/download/%s.pdb.gz"
+
+HEADER = ("HEADER\n"
+	"CRYST1    1.000    1.000    1.000  90.00  90.00  90.00 P 1           1   \n")
+
+RECORDS = ("ATOM", "HETATM", "TER", "MODEL", "ENDMDL")
+
+
+def fetch(code, corpus, mkdssp):
+	"""downloads code into corpus and runs mkdssp on it; an error message, or
+	None"""
+	pdb = os.path.join(corpus, code + ".pdb")
+	dssp = os.path.join(corpus, code + ".dssp")
+	if os.path.exists(pdb) and os.path.exists(dssp):
+		return None
+	try:
+		with urllib.request.urlopen(URL % code.upper(), timeout=60) as response:
+			lines = gzip.decompress(response.read()).decode("latin-1").splitlines()
+	except (urllib.error.URLError, OSError) as e:
+		return "cannot download %s: %s" % (code, e)
+	with open(pdb, "w") as f:
+		f.write(HEADER)
+		for line in lines:
+			if line.startswith(RECORDS):
+				f.write(line + "\n")
+
+	raw = dssp + ".raw"
+	try:
+		subprocess.run([mkdssp, "-i", pdb, "-o", raw], check=True)
+	except (OSError, subprocess.CalledProcessError) as e:
+		os.remove(pdb)
+		return "cannot run %s on %s: %s" % (mkdssp, code, e)
+	with open(raw) as f_in, open(dssp, "w") as f_out:
+		for line in f_in:
+			f_out.write(line.rstrip("\n")[:136] + "\n")
+	os.remove(raw)
+	return None
+
+
+def main():
+	here = os.path.dirname(os.path.abspath(__file__))
+	parser = argparse.ArgumentParser(description="fetch the real structures of the benchmark corpus")
+	parser.add_argument("--corpus", default=os.path.join(here, "corpus"))
+	parser.add_argument("--mkdssp", default="mkdssp")
+	parser.add_argument("codes", nargs="*", default=CODES)
+	args = parser.parse_args()
+	os.makedirs(args.corpus, exist_ok=True)
+
+	failed = 0
+	for code in args.codes:
+		error = fetch(code.lower(), args.corpus, args.mkdssp)
+		if error:
+			failed += 1
+			print("fetch_corpus: %s" % error, file=sys.stderr)
+		else:
+			print("%s: %s" % (code.lower(), args.corpus))
+	sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+	main()
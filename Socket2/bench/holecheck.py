@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""
+					SOCKET
+					 v3.02
+
+					bench/holecheck.py
+
+
+Checks the distance of each knob from each of its 4 hole residues ('make
+holecheck'), as socket2 reports it in the long output file (-o), in the JSON
+results (-J; hole_distances[i] against hole[i]) and in the knob columns (-K;
+hole_distance.col against hole_residue.col; see knobcols.c), against the distance
+recomputed here from the coordinates in the PDB file: that between the centres
+of volume of the side chains (the mean of each residue's heavy atoms other
+than N, C, O and CA; see determine_centre_of_mass()). Each distance must be
+that of the hole residue it is given with, to within the precision printed.
+
+The structures are made by ccgen (as in bench/run_bench.py), together with any
+PDB/DSSP pairs in bench/corpus, and each is run at each of the --cutoffs.
+
+Exits with status 1 if any distance is wrong.
+
+usage: holecheck.py --socket <socket2> --ccgen <ccgen> --work <dir>
+	[--cutoffs <c,c,...>]
+"""
+
+import argparse
+import glob
+import json
+import math
+import os
+import re
+import shutil
+import struct
+import subprocess
+import sys
+
+
+# name: ccgen arguments
+SYNTHETIC = [
+	("dimer", ["-n", "2", "-l", "28", "-j", "0.3", "-s", "1"]),
+	("trimer", ["-n", "3", "-l", "35", "-j", "0.3", "-s", "2"]),
+	("antitet", ["-n", "4", "-l", "32", "-a", "-j", "0.3", "-s", "3"]),
+	("hexamers", ["-n", "6", "-b", "3", "-l", "30", "-j", "0.6", "-s", "8"]),
+]
+
+BACKBONE = ("N", "C", "O", "CA")
+TOLERANCE = 0.002		# the distances are printed to 3 decimal places,
+				# and the columns hold single precision
+
+
+def corpus(args):
+	"""the (name, pdb, dssp) of each structure, generating the synthetic ones"""
+	structures = []
+	for name, ccgen_args in SYNTHETIC:
+		prefix = os.path.join(args.work, name)
+		subprocess.run([args.ccgen, "-o", prefix] + ccgen_args, check=True,
+			stdout=subprocess.DEVNULL)
+		structures.append((name, prefix + ".pdb", prefix + ".dssp"))
+	bundled = os.path.join(os.path.dirname(os.path.abspath(__file__)), "corpus")
+	for pdb in sorted(glob.glob(os.path.join(bundled, "*.pdb"))):
+		dssp = pdb[:-4] + ".dssp"
+		if os.path.exists(dssp):
+			structures.append((os.path.basename(pdb)[:-4], pdb, dssp))
+	return structures
+
+
+def side_chain_centres(pdb):
+	"""the centre of volume of the side chain of each residue, by (chain,
+	number, insertion code)"""
+	atoms = {}
+	with open(pdb) as f:
+		for line in f:
+			if not line.startswith(("ATOM  ", "HETATM")):
+				continue
+			if line[16] not in " A":
+				continue
+			name = line[12:16].strip()
+			element = line[76:78].strip() if len(line) > 77 else ""
+			if (element == "H") or (not element and name.lstrip("0123456789").startswith("H")):
+				continue
+			if name in BACKBONE:
+				continue
+			key = (line[21], int(line[22:26]), line[26])
+			atoms.setdefault(key, []).append(
+				(float(line[30:38]), float(line[38:46]), float(line[46:54])))
+	return dict((key, tuple(sum(a[i] for a in xyz) / len(xyz) for i in range(3)))
+		for key, xyz in atoms.items())
+
+
+KNOB = re.compile(r"^\S+ (\w+)\s+(-?\d+):(.) iCode='(.)'")
+HOLE = re.compile(r"\((\d)\) (\w+)\s*(-?\d+)'(.)'\s+(-?[\d.]+)")
+
+
+def long_output_holes(path):
+	"""the knob residue and the (hole residue, distance) of each hole residue,
+	of each knob in a long output file; residues are (chain, number, insertion
+	code)"""
+	with open(path) as f:
+		for line in f:
+			if "; sides" not in line:
+				continue
+			knob = KNOB.match(line)
+			chain = re.search(r"chain (.): ", line).group(1)
+			holes = [((chain, int(number), icode), float(d)) for m, name, number, icode, d
+				in HOLE.findall(line.split("chain %s: " % chain, 1)[1])]
+			yield (knob.group(3), int(knob.group(2)), knob.group(4)), holes
+
+
+def json_holes(path):
+	"""as long_output_holes(), from the JSON results: hole_distances[i] is
+	taken to be the distance of hole[i]"""
+	with open(path) as f:
+		results = json.load(f)
+	residues = [(r["chain"], r["number"], r["iCode"]) for r in results["residues"]]
+	for knob in results["knobs"]:
+		yield residues[knob["residue"]], list(zip([residues[r] for r in knob["hole"]],
+			knob["hole_distances"]))
+
+
+def column_holes(directory):
+	"""as long_output_holes(), from the knob columns"""
+	def column(name, width, form):
+		with open(os.path.join(directory, name + ".col"), "rb") as f:
+			data = f.read()
+		return [struct.unpack("<" + form, data[i:i + width])
+			for i in range(0, len(data), width)]
+	knobs = zip(column("chain", 1, "c"), column("residue", 4, "i"), column("icode", 1, "c"),
+		column("hole_chain", 1, "c"), column("hole_residue", 16, "4i"),
+		column("hole_distance", 16, "4f"))
+	for (chain,), (number,), (icode,), (hole_chain,), hole_numbers, distances in knobs:
+		chain, icode, hole_chain = chain.decode(), icode.decode(), hole_chain.decode()
+		# the columns hold no insertion codes of the hole residues (None)
+		yield (chain, number, icode), [((hole_chain, n, None), d)
+			for n, d in zip(hole_numbers, distances)]
+
+
+def label(residue):
+	return "%d:%s%s" % (residue[1], residue[0], residue[2].strip())
+
+
+def main():
+	parser = argparse.ArgumentParser(description="check socket2's knob-hole distances")
+	parser.add_argument("--socket", required=True)
+	parser.add_argument("--ccgen", required=True)
+	parser.add_argument("--work", required=True)
+	parser.add_argument("--cutoffs", default="7.0,8.5")
+	args = parser.parse_args()
+	args.socket = os.path.abspath(args.socket)
+	args.ccgen = os.path.abspath(args.ccgen)
+	args.work = os.path.abspath(args.work)
+	os.makedirs(args.work, exist_ok=True)
+
+	knobs = wrong = 0
+	for name, pdb, dssp in corpus(args):
+		centres = side_chain_centres(pdb)
+		for cutoff in args.cutoffs.split(","):
+			long_out = os.path.join(args.work, "holecheck.long")
+			json_out = os.path.join(args.work, "holecheck.json")
+			columns_out = os.path.join(args.work, "holecheck.columns")
+			shutil.rmtree(columns_out, ignore_errors=True)
+			subprocess.run([args.socket, "-f", os.path.abspath(pdb), "-s", os.path.abspath(dssp),
+				"-c", cutoff, "-q", "-o", long_out, "-J", json_out, "-K", columns_out],
+				check=True, stdout=subprocess.DEVNULL, cwd=args.work)
+			for output, holes in (("-o", long_output_holes(long_out)), ("-J", json_holes(json_out)),
+					("-K", column_holes(columns_out))):
+				for residue, holes in holes:
+					knobs += 1
+					for m, (hole, reported) in enumerate(holes):
+						if hole[2] is None:
+							hole = min(key for key in centres if key[:2] == hole[:2])
+						expected = math.dist(centres[residue], centres[hole])
+						if abs(expected - reported) > TOLERANCE:
+							wrong += 1
+							print("WRONG %s -c %s %s: knob %s, hole residue (%d) %s: reported %.3f, "
+								"from the coordinates %.3f" % (name, cutoff, output, label(residue),
+								m, label(hole), reported, expected))
+
+	print("%d knobs checked (in -o, -J and -K together), %d hole distances wrong" % (knobs, wrong))
+	sys.exit(1 if wrong else 0)
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,358 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					bench/microbench.c
+
+
+Description: this C program identifies coiled-coil motifs in a Protein Data Bank
+(Berman et al, Nucleic Acids Res v28 pp235-42, 2000) file. Also required as
+input is a DSSP (Kabsch & Sander, Biopolymers v22 pp 2577-637) file derived from
+the PDB file.
+
+
+*/
+
+/*					microbench.c
+					------------
+
+Micro-benchmarks of the hot functions of SOCKET ('make microbench'), each run
+over and over on the same input, in memory, so that a change to one of them can
+be measured without the noise of file I/O and of the rest of the run. It is
+built from SOCKET's own sources (-DNO_MAIN leaves out socket.c's main()), and
+takes SOCKET's own arguments, e.g.
+
+	microbench -f <PDB file> -s <DSSP file> [ -c <cutoff> ... ]
+
+The structure is first analysed once, as by socket2 with -q (whose output comes
+first), and then each kernel is timed for at least MICRO_SECONDS, and reported
+as a line
+
+	MICRO <code> <kernel> ops=<n> ns/op=<x>
+
+The kernels, and what counts as one op, are:
+
+	read_pdb	read_helical_pdb(), decoding the PDB file from memory
+			(fmemopen()); one op is one line of the file
+	centres		determine_centre_of_mass(); one op is one atom
+	distance	distance() between the side chain centres of two
+			residues; one op is one call
+	residue_pair	measure_helix_pair() over every pair of helices, which
+			calls measure_residue_pair() for each pair of their
+			residues; one op is one residue pair
+	best_kih	best_kih() on the contacts of each pair of helices in
+			turn; one op is one pair of helices (best_kih()
+			rearranges the contacts, so they are restored before
+			each op; the time of restoring them alone is measured
+			separately and taken off)
+	daisy_chains	find_daisy_chains() over the whole knob graph; one op is
+			one call
+	orientation	orientation_of_helices() for each pair of helices whose
+			orientation has been determined; one op is one call
+*/
+
+#include "../socket.h"
+#include <stdlib.h>
+
+#define MICRO_SECONDS 0.5		/* the least time for which each kernel
+					is run */
+#define MICRO_PAIRS 2000		/* the most pairs of helices on which
+					best_kih() is run */
+
+
+static char *pdb_text;			/* the PDB file, in memory */
+static long pdb_size, pdb_lines;
+static int residues, atoms;
+static double residue_pairs;		/* the residue pairs of all the pairs
+					of helices */
+
+
+/* times kernel(), which does ops ops, repeatedly for at least MICRO_SECONDS;
+the nanoseconds per op */
+
+static double time_kernel(void (*kernel)(), double ops, long *total_ops)
+	{
+	double start, elapsed;
+	long calls;
+
+	kernel();	/* once, to warm up */
+	calls = 0;
+	start = monotonic_seconds();
+	do
+		{
+		kernel();
+		calls++;
+		elapsed = monotonic_seconds() - start;
+		}
+	while (elapsed < MICRO_SECONDS);
+
+	*total_ops = (long) (calls * ops);
+	return elapsed * 1e9 / (calls * ops);
+	}
+
+static void report(char kernel[], double ns, long ops)
+	{
+	printf("MICRO %s %s ops=%ld ns/op=%.2f\n",code,kernel,ops,ns);
+	}
+
+
+/* the kernels ................................................................ */
+
+static void kernel_read_pdb()
+	{
+	pdb_file = fmemopen(pdb_text,pdb_size,"r");
+	read_helical_pdb();
+	fclose(pdb_file);
+	}
+
+static void kernel_centres()
+	{
+	determine_centre_of_mass(residues,atoms);
+	}
+
+static volatile float distance_sink;
+
+static void kernel_distance()
+	{
+	int i,j;
+	float sum = 0.0;
+
+	for (i = 0; i < residues; i++)
+		for (j = 0; j < 64; j++)
+			sum += distance(refatom2[i],refatom2[(i + 1 + j) % residues]);
+	distance_sink = sum;
+	}
+
+static void kernel_residue_pair()
+	{
+	int i,j;
+
+	for (i = 0; i < helix_index-1; i++)
+		for (j = i+1; j < helix_index; j++)
+			{
+			list_pair_residues(i,j);
+			reset_contacts();
+			measure_helix_pair(i,j);
+			}
+	}
+
+/* the pairs of helices on which best_kih() is run (those in which a residue
+has more than 4 contacts), and the contacts of their residues before
+best_kih(), pair by pair: those of pair p are kih_saved[kih_start[p]] ..
+kih_saved[kih_start[p+1]-1] */
+
+static int kih_pairs, kih_pair[MICRO_PAIRS][2], kih_start[MICRO_PAIRS+1], kih_saved_n;
+static struct saved_contacts
+	{
+	int residue, n, contact[MAX_CONTACTS];
+	} *kih_saved;
+
+static void restore_contacts(int p)
+	{
+	int s,r;
+
+	list_pair_residues(kih_pair[p][0],kih_pair[p][1]);
+	reset_contacts();
+	for (s = kih_start[p]; s < kih_start[p+1]; s++)
+		{
+		r = kih_saved[s].residue;
+		n_contacts[r] = kih_saved[s].n;
+		memcpy(contact[r],kih_saved[s].contact,n_contacts[r] * sizeof(contact[r][0]));
+		}
+	}
+
+static void record_contacts()
+	{
+	int h,i,j,m,r,busy,size;
+
+	kih_pairs = kih_saved_n = size = 0;
+	kih_saved = NULL;
+	for (i = 0; (i < helix_index-1) && (kih_pairs < MICRO_PAIRS); i++)
+		for (j = i+1; (j < helix_index) && (kih_pairs < MICRO_PAIRS); j++)
+			{
+			list_pair_residues(i,j);
+			reset_contacts();
+			measure_helix_pair(i,j);
+
+			busy = 0;
+			for (h = i; h <= j; h += j - i)
+				for (m = helix_residue_start[h]; m < helix_residue_start[h+1]; m++)
+					if (n_contacts[helix_residue[m]] > 4) busy = 1;
+			if (!busy) continue;
+
+			kih_pair[kih_pairs][0] = i;
+			kih_pair[kih_pairs][1] = j;
+			kih_start[kih_pairs] = kih_saved_n;
+			for (h = i; h <= j; h += j - i)
+				for (m = helix_residue_start[h]; m < helix_residue_start[h+1]; m++)
+					{
+					r = helix_residue[m];
+					if (!n_contacts[r]) continue;
+					if (kih_saved_n == size)
+						{
+						size = size ? 2 * size : 1024;
+						if ((kih_saved = realloc(kih_saved,size * sizeof(*kih_saved))) == NULL)
+							{
+							printf("microbench: out of memory\n");
+							exit(1);
+							}
+						}
+					kih_saved[kih_saved_n].residue = r;
+					kih_saved[kih_saved_n].n = n_contacts[r];
+					memcpy(kih_saved[kih_saved_n++].contact,contact[r],n_contacts[r] * sizeof(contact[r][0]));
+					}
+			kih_start[++kih_pairs] = kih_saved_n;
+			}
+	}
+
+static void kernel_restore()
+	{
+	int p;
+
+	for (p = 0; p < kih_pairs; p++) restore_contacts(p);
+	}
+
+static void kernel_best_kih()
+	{
+	int p;
+
+	for (p = 0; p < kih_pairs; p++)
+		{
+		restore_contacts(p);
+		best_kih();
+		}
+	}
+
+static void kernel_daisy_chains()
+	{
+	find_daisy_chains();
+	}
+
+/* the pairs of helices whose orientation has been determined */
+
+static int orientation_pairs, (*orientation_pair)[2];
+static volatile int orientation_sink;
+
+static void kernel_orientation()
+	{
+	int p,sum = 0;
+
+	for (p = 0; p < orientation_pairs; p++)
+		sum += orientation_of_helices(orientation_pair[p][1],orientation_pair[p][0]);
+	orientation_sink = sum;
+	}
+
+
+/* the analysis, as in main() ................................................ */
+
+static void analyse()
+	{
+	int i,j;
+	long c;
+	FILE *in;
+
+	/* keep the whole PDB file, before read_helical_pdb() reads it */
+	in = pdb_file;
+	fseek(in,0,SEEK_END);
+	pdb_size = ftell(in);
+	rewind(in);
+	if ((pdb_text = malloc(pdb_size + 1)) == NULL)
+		{
+		printf("microbench: out of memory\n");
+		exit(1);
+		}
+	if (fread(pdb_text,1,pdb_size,in) != pdb_size)
+		{
+		printf("microbench: failed to read the PDB file\n");
+		exit(1);
+		}
+	rewind(in);
+	pdb_lines = 0;
+	for (c = 0; c < pdb_size; c++) if (pdb_text[c] == '\n') pdb_lines++;
+
+	if (extend)
+		pre_parse_dssp(&helix_index, helix_start, helix_start_iCode,
+		helix_end, helix_end_iCode, helix_chain, extend);
+	residues = read_helical_dssp(extend);
+	index_helix_residues(residues);
+	atoms = read_helical_pdb();
+	determine_centre_of_mass(residues,atoms);
+	determine_end(residues,atoms);
+	determine_helix_axes(residues);
+	find_knobs_and_holes(residues);
+	if (determine_order(residues)) find_register();
+
+	orientation_pairs = 0;
+	orientation_pair = malloc((helix_index * helix_index / 2 + 1) * sizeof(*orientation_pair));
+	if (orientation_pair == NULL)
+		{
+		printf("microbench: out of memory\n");
+		exit(1);
+		}
+	residue_pairs = 0.0;
+	for (i = 0; i < helix_index-1; i++)
+		for (j = i+1; j < helix_index; j++)
+			{
+			if (helix_pair_orientation[i][j] != -1)
+				{
+				orientation_pair[orientation_pairs][0] = i;
+				orientation_pair[orientation_pairs++][1] = j;
+				}
+			residue_pairs += (double) (helix_residue_start[i+1] - helix_residue_start[i]) *
+				(helix_residue_start[j+1] - helix_residue_start[j]);
+			}
+	}
+
+
+int main(int argc, char *argv[])
+	{
+	long ops, restore_ops;
+	double ns, restore_ns;
+
+	statchar();
+	initialize(argc,argv);
+	setflag[flag_q] = true;
+	check_files();
+	analyse();
+
+	printf("\nmicrobench %s: %d helices, %d residues, %d atoms, %d knobs, %d daisy chains\n",
+		code,helix_index,residues,atoms,knob_index,daisy_chains);
+
+	ns = time_kernel(kernel_read_pdb,pdb_lines,&ops);
+	report("read_pdb",ns,ops);
+
+	if (setflag[flag_m]) printf("MICRO %s centres not run (the atoms are not kept with -m)\n",code);
+	else
+		{
+		ns = time_kernel(kernel_centres,atoms,&ops);
+		report("centres",ns,ops);
+		}
+
+	ns = time_kernel(kernel_distance,residues * 64.0,&ops);
+	report("distance",ns,ops);
+
+	ns = time_kernel(kernel_residue_pair,residue_pairs,&ops);
+	report("residue_pair",ns,ops);
+
+	record_contacts();
+	if (kih_pairs)
+		{
+		restore_ns = time_kernel(kernel_restore,kih_pairs,&restore_ops);
+		ns = time_kernel(kernel_best_kih,kih_pairs,&ops);
+		report("best_kih",ns - restore_ns,ops);
+		}
+	else printf("MICRO %s best_kih not run (no residue has more than 4 contacts)\n",code);
+
+	ns = time_kernel(kernel_daisy_chains,1,&ops);
+	report("daisy_chains",ns,ops);
+
+	if (orientation_pairs)
+		{
+		ns = time_kernel(kernel_orientation,orientation_pairs,&ops);
+		report("orientation",ns,ops);
+		}
+	else printf("MICRO %s orientation not run (no pair of helices has an orientation)\n",code);
+
+	return 0;
+	}
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+					SOCKET
+					 v3.02
+
+					bench/ordercheck.py
+
+
+Checks the combinations of helices that determine_order() counts ('make
+ordercheck'): each daisy chain must be counted as the coiled coil of exactly
+its own helices, and not as a larger one that begins with them. So every
+coiled coil of 3 or more helices listed in the output (as 'coiled coil N: ...
+frequency F') must have a frequency equal to the number of daisy chains whose
+knobs lie on exactly its helices (taken from the JSON results, -J; see
+json.c), and every such set of helices must be listed.
+
+The structures are made by ccgen (tetramers, with and without antiparallel
+helices, and pentamers, which have daisy chains of fewer helices than their
+coiled coils), together with any PDB/DSSP pairs in bench/corpus, and each is
+run at each of the --cutoffs.
+
+Exits with status 1 if any combination is miscounted.
+
+usage: ordercheck.py --socket <socket2> --ccgen <ccgen> --work <dir>
+	[--cutoffs <c,c,...>]
+"""
+
+import argparse
+import collections
+import glob
+import json
+import os
+import re
+import subprocess
+import sys
+
+
+# name: ccgen arguments
+SYNTHETIC = [
+	("trimer", ["-n", "3", "-l", "35", "-j", "0.3", "-s", "2"]),
+	("tetramer", ["-n", "4", "-l", "32", "-j", "0.3", "-s", "4"]),
+	("antitet", ["-n", "4", "-l", "32", "-a", "-j", "0.3", "-s", "3"]),
+	("noisy_antitet", ["-n", "4", "-l", "40", "-a", "-j", "0.8", "-s", "11"]),
+	("pentamer", ["-n", "5", "-l", "32", "-j", "0.4", "-s", "5"]),
+	("hexamers", ["-n", "6", "-b", "3", "-l", "30", "-j", "0.6", "-s", "8"]),
+]
+
+COILED_COIL = re.compile(r"^coiled coil\s+(\d+):\s+(\d+) helices\s+([\d ]+?)\s+frequency (\d+)")
+
+
+def corpus(args):
+	"""the (name, pdb, dssp) of each structure, generating the synthetic ones"""
+	structures = []
+	for name, ccgen_args in SYNTHETIC:
+		prefix = os.path.join(args.work, name)
+		subprocess.run([args.ccgen, "-o", prefix] + ccgen_args, check=True,
+			stdout=subprocess.DEVNULL)
+		structures.append((name, prefix + ".pdb", prefix + ".dssp"))
+	bundled = os.path.join(os.path.dirname(os.path.abspath(__file__)), "corpus")
+	for pdb in sorted(glob.glob(os.path.join(bundled, "*.pdb"))):
+		dssp = pdb[:-4] + ".dssp"
+		if os.path.exists(dssp):
+			structures.append((os.path.basename(pdb)[:-4], pdb, dssp))
+	return structures
+
+
+def listed_coiled_coils(output):
+	"""the helices (a tuple) and frequency of each coiled coil listed in the
+	text output, by number"""
+	listed = {}
+	for line in output.splitlines():
+		m = COILED_COIL.match(line)
+		if m:
+			listed[int(m.group(1))] = (tuple(int(h) for h in m.group(3).split()),
+				int(m.group(4)))
+	return listed
+
+
+def daisy_chain_helices(results):
+	"""the number of daisy chains on each set of helices (a sorted tuple)"""
+	helix = dict((k["id"], k["helix"]) for k in results["knobs"])
+	return collections.Counter(tuple(sorted(set(helix[k] for k in d["knobs"])))
+		for d in results["daisy_chains"])
+
+
+def main():
+	parser = argparse.ArgumentParser(description="check socket2's count of coiled coils")
+	parser.add_argument("--socket", required=True)
+	parser.add_argument("--ccgen", required=True)
+	parser.add_argument("--work", required=True)
+	parser.add_argument("--cutoffs", default="7.0,8.5")
+	args = parser.parse_args()
+	args.socket = os.path.abspath(args.socket)
+	args.ccgen = os.path.abspath(args.ccgen)
+	args.work = os.path.abspath(args.work)
+	os.makedirs(args.work, exist_ok=True)
+
+	checked = wrong = 0
+	for name, pdb, dssp in corpus(args):
+		for cutoff in args.cutoffs.split(","):
+			json_out = os.path.join(args.work, "ordercheck.json")
+			output = subprocess.run([args.socket, "-f", os.path.abspath(pdb), "-s",
+				os.path.abspath(dssp), "-c", cutoff, "-J", json_out], check=True,
+				stdout=subprocess.PIPE, universal_newlines=True, errors="replace",
+				cwd=args.work).stdout
+			with open(json_out) as f:
+				chains = daisy_chain_helices(json.load(f))
+			listed = listed_coiled_coils(output)
+			by_helices = dict((helices, (number, frequency))
+				for number, (helices, frequency) in listed.items())
+			for number, (helices, frequency) in sorted(listed.items()):
+				if len(helices) < 3:
+					continue
+				checked += 1
+				if frequency != chains[helices]:
+					wrong += 1
+					print("WRONG %s -c %s: coiled coil %d (helices %s) has frequency %d, "
+						"but %d daisy chains lie on exactly those helices" % (name, cutoff,
+						number, " ".join(map(str, helices)), frequency, chains[helices]))
+			for helices, n in sorted(chains.items()):
+				if (len(helices) >= 3) and (helices not in by_helices):
+					wrong += 1
+					print("WRONG %s -c %s: %d daisy chains lie on helices %s, which are not "
+						"listed as a coiled coil" % (name, cutoff, n, " ".join(map(str, helices))))
+
+	print("%d coiled coils of 3 or more helices checked, %d miscounted" % (checked, wrong))
+	sys.exit(1 if wrong else 0)
+
+
+if __name__ == "__main__":
+	main()
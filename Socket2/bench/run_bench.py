@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""
+					SOCKET
+					 v3.02
+
+					bench/run_bench.py
+
+
+Runs socket2 over the benchmark corpus and writes the timings as JSON
+('make bench'; see the Makefile and README).
+
+The corpus is generated with ccgen, so that it is the same everywhere:
+
+	dimer		a parallel dimer
+	trimer		a parallel trimer
+	antitet		an antiparallel tetramer
+	assembly	a large assembly: 20 hexamers (120 helices)
+	scale_16 ..	the scaling series: 8, 32 and 128 dimers (16, 64 and
+	scale_256	256 helices), for the contact search, which grows with
+			the square of the number of helices
+
+together with any PDB/DSSP pairs in bench/corpus (<name>.pdb and <name>.dssp):
+the real structures fetched by 'make corpus' (see fetch_corpus.py), or others.
+
+ccgen names at most 62 chains (A-Z, a-z, 0-9, the chain identifiers that
+socket2 reads), so the assembly and scale_256 put two to five helices on each
+chain, as in a structure of long multi-helix chains.
+
+With --training, the structures are instead those of TRAINING: made by ccgen
+too, but of other shapes and sizes and from other seeds, and without those of
+bench/corpus, so that a profile-guided build (see the Makefile's PGO_BUILD) is
+trained on structures apart from those on which it is measured.
+
+Each structure is run --repeat times with -T, and the median of each stage time
+(see profile.c) is recorded, along with the counts of work done. The totals give
+the throughput: structures per second, and residue pairs per second in the
+contact search of the knobs-into-holes search (the contacts stage).
+
+usage: run_bench.py --socket <socket2> --ccgen <ccgen> --work <dir> --out <json>
+	[--repeat <n>] [--training]
+"""
+
+import argparse
+import glob
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import time
+
+
+# name: ccgen arguments
+SYNTHETIC = [
+	("dimer", ["-n", "2", "-l", "28", "-j", "0.3", "-s", "1"]),
+	("trimer", ["-n", "3", "-l", "35", "-j", "0.3", "-s", "2"]),
+	("antitet", ["-n", "4", "-l", "32", "-a", "-j", "0.3", "-s", "3"]),
+	("assembly", ["-n", "6", "-b", "20", "-l", "35", "-j", "0.4", "-s", "4"]),
+	("scale_16", ["-n", "2", "-b", "8", "-l", "28", "-j", "0.3", "-s", "5"]),
+	("scale_64", ["-n", "2", "-b", "32", "-l", "28", "-j", "0.3", "-s", "6"]),
+	("scale_256", ["-n", "2", "-b", "128", "-l", "28", "-j", "0.3", "-s", "7"]),
+]
+
+# the training set of a profile-guided build: none of these is in SYNTHETIC
+TRAINING = [
+	("train_dimer", ["-n", "2", "-l", "40", "-j", "0.5", "-s", "101"]),
+	("train_antitet", ["-n", "4", "-l", "30", "-a", "-j", "0.4", "-s", "102"]),
+	("train_pentamers", ["-n", "5", "-b", "6", "-l", "30", "-j", "0.5", "-s", "103"]),
+	("train_trimers", ["-n", "3", "-b", "40", "-l", "32", "-j", "0.3", "-s", "104"]),
+	("train_dimers", ["-n", "2", "-b", "64", "-l", "30", "-j", "0.4", "-s", "105"]),
+]
+
+
+def corpus(args):
+	"""the (name, pdb, dssp) of each structure, generating the synthetic ones"""
+	os.makedirs(args.work, exist_ok=True)
+	structures = []
+	for name, ccgen_args in (TRAINING if args.training else SYNTHETIC):
+		prefix = os.path.join(args.work, name)
+		subprocess.run([args.ccgen, "-o", prefix] + ccgen_args, check=True,
+			stdout=subprocess.DEVNULL)
+		structures.append((name, prefix + ".pdb", prefix + ".dssp"))
+	if args.training:
+		return structures
+
+	bundled = os.path.join(os.path.dirname(os.path.abspath(__file__)), "corpus")
+	for pdb in sorted(glob.glob(os.path.join(bundled, "*.pdb"))):
+		dssp = pdb[:-4] + ".dssp"
+		if os.path.exists(dssp):
+			structures.append((os.path.basename(pdb)[:-4], pdb, dssp))
+		else:
+			print("run_bench: %s has no DSSP file; left out" % pdb, file=sys.stderr)
+	return structures
+
+
+def profile(line):
+	"""the stage times, total and counts of a PROFILE line (see
+	report_profile()); the stages come before total=, the counts after it, and
+	a name (knobs) can be both"""
+	stages, counts, total = {}, {}, None
+	for field in line.split()[2:]:
+		key, value = field.split("=", 1)
+		if key == "total":
+			total = float(value)
+		elif total is None:
+			stages[key] = float(value)
+		else:
+			counts[key] = int(value)
+	return stages, total, counts
+
+
+def run(args, name, pdb, dssp):
+	runs = []
+	for i in range(args.repeat):
+		start = time.monotonic()
+		result = subprocess.run([args.socket, "-f", pdb, "-s", dssp, "-q", "-T"],
+			stdout=subprocess.PIPE, universal_newlines=True, cwd=args.work)
+		wall = time.monotonic() - start
+		lines = [l for l in result.stdout.splitlines() if l.startswith("PROFILE ")]
+		if result.returncode or not lines:
+			sys.exit("run_bench: socket2 failed on %s:\n%s" % (name, result.stdout[-2000:]))
+		runs.append(profile(lines[-1]) + (wall,))
+
+	stages, total, counts = runs[0][:3]
+	return {"name": name,
+		"total": statistics.median(r[1] for r in runs),
+		"wall": statistics.median(r[3] for r in runs),
+		"stages": dict((stage, statistics.median(r[0][stage] for r in runs)) for stage in stages),
+		"counts": counts}
+
+
+def main():
+	parser = argparse.ArgumentParser(description="benchmark socket2")
+	parser.add_argument("--socket", required=True)
+	parser.add_argument("--ccgen", required=True)
+	parser.add_argument("--work", required=True)
+	parser.add_argument("--out", required=True)
+	parser.add_argument("--repeat", type=int, default=3)
+	parser.add_argument("--training", action="store_true")
+	args = parser.parse_args()
+	args.socket = os.path.abspath(args.socket)
+	args.ccgen = os.path.abspath(args.ccgen)
+
+	records = []
+	for name, pdb, dssp in corpus(args):
+		record = run(args, name, os.path.abspath(pdb), os.path.abspath(dssp))
+		records.append(record)
+		print("%-12s total %9.6f s  residue pairs %10d" % (name, record["total"],
+			record["counts"]["residue_pairs"]))
+
+	total = sum(r["total"] for r in records)
+	contacts = sum(r["stages"]["contacts"] for r in records)
+	pairs = sum(r["counts"]["residue_pairs"] for r in records)
+	results = {
+		"machine": platform.node(),
+		"platform": platform.platform(),
+		"date": time.strftime("%Y-%m-%dT%H:%M:%S"),
+		"repeat": args.repeat,
+		"structures": records,
+		"throughput": {
+			"structures_per_second": len(records) / total if total else None,
+			"residue_pairs_per_second": pairs / contacts if contacts else None,
+		},
+	}
+	with open(args.out, "w") as out:
+		json.dump(results, out, indent=1)
+		out.write("\n")
+	print("%d structures, %.1f structures/s, %.3g residue pairs/s; written to %s" % (
+		len(records), results["throughput"]["structures_per_second"] or 0,
+		results["throughput"]["residue_pairs_per_second"] or 0, args.out))
+
+
+if __name__ == "__main__":
+	main()
@@ -0,0 +1,336 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					ccgen.c
+
+
+Description: generates synthetic coiled-coil structures for exercising and
+benchmarking SOCKET; writes a Protein Data Bank file and a matching DSSP file
+in which every generated helix is assigned as alpha-helix ('H').
+
+
+*/
+
+/*					ccgen.c
+					-------
+
+Each bundle is an ideal coiled coil of N alpha-helices built from the Crick
+parameterization: the local helix axis follows a left-handed supercoil of
+radius R0 and pitch P about an axis parallel to z, and the C-alpha atoms follow
+a right-handed alpha-helix of radius 2.26 Angstroms about that local axis, with
+3.5 residues per turn relative to the supercoil (i.e. a heptad repeat); the
+a and d positions are phased to point at the supercoil axis. Side chains are
+built as straight (branched, for Leu) extensions along the radial direction,
+which is crude, but gives SOCKET what it uses: centres of volume, 'end' atoms,
+C-alpha and C-beta atoms.
+
+Bundles are tiled on a square grid in the xy plane, far enough apart not to
+interact. Helices are distributed over up to 62 chains (A-Z, a-z and 0-9, the
+chain identifiers SOCKET tells apart; see MAX_SEQCHAINS in preproc.h); when
+there are more helices than chains, several helices share a chain, separated
+by short non-helical glycine loops. Residue numbers are limited to 4 digits by
+the fixed-column formats, so a chain holds about 9999 / (length + 5) helices:
+some 18700 helices of 28 residues in all, although SOCKET itself must then be
+built with larger limits (MAX_HELICES, MAX_RESIDUES etc. in preproc.h) to read
+them.
+
+ccgen is built by 'make ccgen' (see Makefile); it does not use any of SOCKET's
+sources.
+
+The output is deterministic for a given set of arguments; -s seeds a small
+amount of coordinate noise (default 0, i.e. ideal geometry) so that repeated
+runs with different seeds give distinct but comparable inputs.
+
+usage: ccgen -o <prefix> [-n <helices per bundle>] [-l <helix length>]
+	[-b <bundles>] [-a] [-R <supercoil radius>] [-P <supercoil pitch>]
+	[-s <seed>] [-j <coordinate noise (Angstroms)>]
+
+	-a	make alternate helices of each bundle antiparallel
+	-o	writes <prefix>.pdb and <prefix>.dssp
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define HELIX_RADIUS 2.26		/* radius of the C-alpha helix */
+#define RISE 1.51			/* rise per residue along the supercoil
+					axis */
+#define HEPTAD_PHASE 102.857142857	/* degrees per residue about the local
+					helix axis, in the supercoil frame */
+#define INTERHELICAL_DISTANCE 9.8	/* used to choose a default supercoil
+					radius from the oligomeric state */
+#define BUNDLE_SPACING 40.0		/* extra clearance between the
+					supercoils of neighbouring bundles */
+#define LOOP_LENGTH 4			/* glycine residues separating two
+					helices within the same chain */
+#define MAX_CHAINS 62
+#define MAX_RESSEQ 9999
+
+/* the chain identifiers SOCKET reads (see read.c) */
+static char chain_ids[MAX_CHAINS + 1] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+static char heptad[8] = "LEALEKK";	/* abcdefg */
+
+static FILE *pdb, *dssp;
+static int serial, dssp_serial;
+static unsigned long rng_state;
+static double noise;
+
+/* a small linear congruential generator, so that the output does not depend
+	on the C library's rand() */
+static double uniform()
+	{
+	rng_state = rng_state * 6364136223846793005UL + 1442695040888963407UL;
+	return (double) ((rng_state >> 11) & 0xFFFFFFFFFFFFFUL) / (double) 0x10000000000000UL;
+	}
+
+static double jitter()
+	{
+	return noise ? noise * (2.0 * uniform() - 1.0) : 0.0;
+	}
+
+static void write_atom(char *name, char *resName, char chain, int resSeq, double p[])
+	{
+	fprintf(pdb,"ATOM  %5d %s %s %c%4d    %8.3f%8.3f%8.3f  1.00 20.00           %c\n",
+		serial++ % 100000, name, resName, chain, resSeq,
+		p[0] + jitter(), p[1] + jitter(), p[2] + jitter(), name[1]);
+	}
+
+static void write_dssp(int resSeq, char chain, char aa, char ss)
+	{
+	fprintf(dssp,"%5d%5d %c %c  %c                0   0    0      0, 0.0     0, 0.0     0, 0.0     0, 0.0   0.000 360.0 360.0 360.0 360.0    0.0    0.0    0.0\n",
+		dssp_serial++ % 100000, resSeq, chain, aa, ss);
+	}
+
+/* p = a + s*u + t*v + w*x */
+static void place(double p[], double a[], double s, double u[], double t, double v[], double w, double x[])
+	{
+	int i;
+	for (i = 0; i < 3; i++) p[i] = a[i] + s * u[i] + t * v[i] + w * x[i];
+	}
+
+static void write_residue(char aa, char chain, int resSeq, double ca[], double radial[],
+	double along[], double across[])
+	{
+	double n[3], c[3], o[3], cb[3], cg[3], cd[3], ce[3], end1[3], end2[3];
+	char *resName;
+
+	place(n, ca, -0.5, radial, -1.2, along, 0.6, across);
+	place(c, ca, -0.4, radial, 1.3, along, -0.5, across);
+	place(o, c, 0.3, radial, 0.6, along, -1.0, across);
+	place(cb, ca, 1.45, radial, 0.45, along, 0.0, across);
+	place(cg, cb, 1.45, radial, 0.45, along, 0.0, across);
+	place(cd, cg, 1.45, radial, 0.45, along, 0.0, across);
+	place(ce, cd, 1.45, radial, 0.45, along, 0.0, across);
+
+	switch (aa)
+		{
+		case 'A': resName = "ALA"; break;
+		case 'E': resName = "GLU"; break;
+		case 'K': resName = "LYS"; break;
+		case 'L': resName = "LEU"; break;
+		default: resName = "GLY"; break;
+		}
+
+	write_atom(" N  ", resName, chain, resSeq, n);
+	write_atom(" CA ", resName, chain, resSeq, ca);
+	write_atom(" C  ", resName, chain, resSeq, c);
+	write_atom(" O  ", resName, chain, resSeq, o);
+	if (aa != 'G') write_atom(" CB ", resName, chain, resSeq, cb);
+	switch (aa)
+		{
+		case 'E':
+			write_atom(" CG ", resName, chain, resSeq, cg);
+			write_atom(" CD ", resName, chain, resSeq, cd);
+			place(end1, cd, 0.9, radial, 0.0, along, 0.9, across);
+			place(end2, cd, 0.9, radial, 0.0, along, -0.9, across);
+			write_atom(" OE1", resName, chain, resSeq, end1);
+			write_atom(" OE2", resName, chain, resSeq, end2);
+			break;
+		case 'K':
+			write_atom(" CG ", resName, chain, resSeq, cg);
+			write_atom(" CD ", resName, chain, resSeq, cd);
+			write_atom(" CE ", resName, chain, resSeq, ce);
+			place(end1, ce, 1.45, radial, 0.0, along, 0.0, across);
+			write_atom(" NZ ", resName, chain, resSeq, end1);
+			break;
+		case 'L':
+			write_atom(" CG ", resName, chain, resSeq, cg);
+			place(end1, cg, 0.9, radial, 0.3, along, 1.2, across);
+			place(end2, cg, 0.9, radial, 0.3, along, -1.2, across);
+			write_atom(" CD1", resName, chain, resSeq, end1);
+			write_atom(" CD2", resName, chain, resSeq, end2);
+			break;
+		}
+	write_dssp(resSeq, chain, aa, aa == 'G' ? ' ' : 'H');
+	}
+
+int main(int argc, char *argv[])
+	{
+	int i, j, k, b, h, t, helix, oligomer, length, bundles, antiparallel,
+		grid, chains, helices_per_chain, chain_helix, next_resSeq[MAX_CHAINS];
+	unsigned long seed;
+	double radius, pitch, omega0, theta, phi, phi1, spacing, origin[3], axis[3],
+		radial[3], along[3], across[3], ca[3], loop[3], norm;
+	char *prefix, file_name[FILENAME_MAX], chain;
+
+	oligomer = 2; length = 28; bundles = 1; antiparallel = 0;
+	radius = -1; pitch = 150.0; seed = 0; noise = 0.0; prefix = NULL;
+
+	for (i = 1; i < argc; i++)
+		if (!strcmp(argv[i],"-a")) antiparallel = 1;
+		else if (i == argc - 1) break;
+		else if (!strcmp(argv[i],"-n")) oligomer = atoi(argv[++i]);
+		else if (!strcmp(argv[i],"-l")) length = atoi(argv[++i]);
+		else if (!strcmp(argv[i],"-b")) bundles = atoi(argv[++i]);
+		else if (!strcmp(argv[i],"-R")) radius = atof(argv[++i]);
+		else if (!strcmp(argv[i],"-P")) pitch = atof(argv[++i]);
+		else if (!strcmp(argv[i],"-s")) seed = strtoul(argv[++i],NULL,10);
+		else if (!strcmp(argv[i],"-j")) noise = atof(argv[++i]);
+		else if (!strcmp(argv[i],"-o")) prefix = argv[++i];
+
+	if ((prefix == NULL) || (i < argc) || (oligomer < 1) || (length < 1) || (bundles < 1))
+		{
+		printf("usage: %s -o <prefix> [-n <helices per bundle>] [-l <helix length>] [-b <bundles>] [-a]\n\t[-R <supercoil radius>] [-P <supercoil pitch>] [-s <seed>] [-j <coordinate noise>]\n",
+			argv[0]);
+		exit(1);
+		}
+
+	/* the supercoil radius which puts neighbouring helices of the bundle
+	INTERHELICAL_DISTANCE apart */
+	if (radius < 0)
+		radius = (oligomer == 1) ? 0.0 : INTERHELICAL_DISTANCE / (2.0 * sin(M_PI / oligomer));
+
+	chains = oligomer * bundles;
+	if (chains > MAX_CHAINS) chains = MAX_CHAINS;
+	helices_per_chain = (oligomer * bundles + chains - 1) / chains;
+	if (helices_per_chain * (length + LOOP_LENGTH + 1) > MAX_RESSEQ)
+		{
+		printf("%d helices of length %d will not fit into %d chains\n",
+			oligomer * bundles, length, chains);
+		exit(1);
+		}
+
+	sprintf(file_name,"%s.pdb",prefix);
+	if ((pdb = fopen(file_name,"w")) == NULL)
+		{
+		printf("Cannot open %s for writing\n",file_name);
+		exit(1);
+		}
+	sprintf(file_name,"%s.dssp",prefix);
+	if ((dssp = fopen(file_name,"w")) == NULL)
+		{
+		printf("Cannot open %s for writing\n",file_name);
+		exit(1);
+		}
+
+	fprintf(pdb,"HEADER    SYNTHETIC COILED COIL                   01-JAN-00   XXXX\n");
+	fprintf(pdb,"REMARK   1 ccgen: %d bundle(s) of %d %s helices of %d residues\n",
+		bundles, oligomer, antiparallel ? "antiparallel" : "parallel", length);
+	fprintf(pdb,"REMARK   1 ccgen: supercoil radius %.3f pitch %.3f seed %lu noise %.3f\n",
+		radius, pitch, seed, noise);
+	fprintf(dssp,"==== Secondary Structure Definition by the program DSSP (synthetic, ccgen) ==== DATE=01-JAN-00\n");
+	fprintf(dssp,"HEADER    SYNTHETIC COILED COIL                   01-JAN-00   XXXX\n");
+	fprintf(dssp,"  #  RESIDUE AA STRUCTURE BP1 BP2  ACC     N-H-->O    O-->H-N    N-H-->O    O-->H-N    TCO  KAPPA ALPHA  PHI   PSI    X-CA   Y-CA   Z-CA\n");
+
+	rng_state = seed * 2654435761UL + 1;
+	serial = 1;
+	dssp_serial = 1;
+	for (i = 0; i < MAX_CHAINS; i++) next_resSeq[i] = 1;
+
+	grid = (int) ceil(sqrt((double) bundles));
+	spacing = 2.0 * radius + BUNDLE_SPACING;
+	omega0 = -2.0 * M_PI * RISE / pitch;	/* left-handed supercoil */
+	phi1 = M_PI + 0.5 * (360.0 - 3 * HEPTAD_PHASE) * M_PI / 180.0; /* a position */
+
+	/* helices are written chain by chain, so that each chain's residue
+	numbers increase through the file */
+	for (k = 0; k < chains; k++)
+		{
+		chain = chain_ids[k];
+		for (chain_helix = 0; chain_helix < helices_per_chain; chain_helix++)
+			{
+			helix = chain_helix * chains + k;
+			if (helix >= oligomer * bundles) break;
+			b = helix / oligomer;
+			h = helix % oligomer;
+			origin[0] = spacing * (b % grid);
+			origin[1] = spacing * (b / grid);
+			origin[2] = 0.0;
+
+			if (chain_helix)
+				{
+				/* a short loop off the end of the previous helix */
+				for (j = 0; j < LOOP_LENGTH; j++)
+					{
+					loop[0] = origin[0] + (radius + 12.0) * cos(2.0 * M_PI * h / oligomer);
+					loop[1] = origin[1] + (radius + 12.0) * sin(2.0 * M_PI * h / oligomer);
+					loop[2] = -8.0 - 3.8 * j;
+					radial[0] = 1.0; radial[1] = 0.0; radial[2] = 0.0;
+					along[0] = 0.0; along[1] = 0.0; along[2] = 1.0;
+					across[0] = 0.0; across[1] = 1.0; across[2] = 0.0;
+					write_residue('G', chain, next_resSeq[k]++, loop, radial, along, across);
+					}
+				}
+
+			for (i = 0; i < length; i++)
+				{
+				/* position t along the supercoil; antiparallel helices run
+				from the top of the bundle to the bottom */
+				t = (antiparallel && (h % 2)) ? length - 1 - i : i;
+				theta = 2.0 * M_PI * h / oligomer + omega0 * t;
+				phi = phi1 + HEPTAD_PHASE * M_PI / 180.0 * t;
+
+				axis[0] = origin[0] + radius * cos(theta);
+				axis[1] = origin[1] + radius * sin(theta);
+				axis[2] = origin[2] + RISE * t;
+
+				/* the local frame: out from the supercoil axis, along the
+				local helix axis, and the binormal */
+				along[0] = -radius * omega0 * sin(theta);
+				along[1] = radius * omega0 * cos(theta);
+				along[2] = RISE;
+				norm = sqrt(along[0]*along[0] + along[1]*along[1] + along[2]*along[2]);
+				for (j = 0; j < 3; j++) along[j] /= norm;
+				radial[0] = cos(theta); radial[1] = sin(theta); radial[2] = 0.0;
+				across[0] = along[1]*radial[2] - along[2]*radial[1];
+				across[1] = along[2]*radial[0] - along[0]*radial[2];
+				across[2] = along[0]*radial[1] - along[1]*radial[0];
+
+				for (j = 0; j < 3; j++)
+					ca[j] = axis[j] + HELIX_RADIUS * (cos(phi) * radial[j] + sin(phi) * across[j]);
+
+				/* the side chain points out from the local helix axis */
+				for (j = 0; j < 3; j++)
+					radial[j] = cos(phi) * radial[j] + sin(phi) * across[j];
+				across[0] = along[1]*radial[2] - along[2]*radial[1];
+				across[1] = along[2]*radial[0] - along[0]*radial[2];
+				across[2] = along[0]*radial[1] - along[1]*radial[0];
+				if (antiparallel && (h % 2))
+					for (j = 0; j < 3; j++) { along[j] = -along[j]; across[j] = -across[j]; }
+
+				write_residue(heptad[t % 7], chain, next_resSeq[k]++, ca, radial, along, across);
+				}
+
+			/* a non-helical C-cap, so that DSSP-style helix ends are never
+			adjacent to a chain break */
+			for (j = 0; j < 3; j++) ca[j] += 3.8 * along[j];
+			write_residue('G', chain, next_resSeq[k]++, ca, radial, along, across);
+			}
+		fprintf(pdb,"TER\n");
+		if (k < chains - 1)
+			fprintf(dssp,"%5d        !                0   0    0      0, 0.0     0, 0.0     0, 0.0     0, 0.0   0.000 360.0 360.0 360.0 360.0    0.0    0.0    0.0\n",
+				dssp_serial++ % 100000);
+		}
+	fprintf(pdb,"END\n");
+
+	fclose(pdb);
+	fclose(dssp);
+	return 0;
+	}
@@ -27,151 +27,289 @@ the PDB file.
 
 /*					daisies.c
 					---------
+
+A 'daisy chain' is a closed cycle of N > 2 knobs, in which each knob fits into
+a hole one of whose two sides (the residues knob[k].hole[1] and knob[k].hole[2]) is the
+next knob of the cycle; the knobs form a layer perpendicular to the coiled-coil
+axis, and are the hallmark of coiled coils with more than 2 strands.
+
+The knobs-into-holes interactions are held as a directed graph, built by
+build_knob_graph(): knob k is linked to every knob k2 whose residue is one of
+the two sides of the hole into which k fits, provided that k2's own hole is not
+in the helix of k (if it were, k and k2 would simply be pairwise
+complementary, which is dealt with by complementary() in knobs.c). The graph is
+stored in compressed sparse row form (GLOBAL knob_link_start[], knob_link[]).
+
+The daisy chains are then the elementary cycles of this graph which visit each
+helix at most once (one knob per helix; in dense packing, at a high packing-
+cutoff, there can also be longer cycles which wind twice around the same
+helices, and these are not daisy chains), and find_daisy_chains() enumerates
+them by a plain depth-first search, bounded in depth. (It is not Johnson's
+algorithm (SIAM J Comput v4 pp77-84, 1975), whose blocking of knobs from which
+the start cannot be reached would not be valid here: a path can also be cut
+off by the helices already visited, and a knob blocked on one path may close a
+cycle on another.)
+
+	the graph is first split into its strongly connected components; a
+		cycle can never leave its component, and knobs which are not in
+		a component of at least 3 knobs are not part of any daisy chain,
+		so cost nothing further
+
+	each cycle is traced once only, from its lowest-numbered knob, by a
+		depth-first search which is confined to that knob's component
+		and to higher-numbered knobs, and which never revisits a helix
+		already on the current path; the depth is bounded at MAX_DAISIES
+
+Every daisy chain is therefore found in a single pass, including those which
+tracing a single path of knobs from each knob in turn could miss (e.g. where a
+knob belongs to two daisy chains, as in Stat3B 1bg1 and in gp41-like
+arrangements, or where the path traced from a knob runs into a daisy chain
+of which the knob is not itself part, as in 1aik). The cost is the number of
+paths over distinct helices within the cyclic components: small in ordinary
+coiled coils, but it grows quickly with the number of helices packed together
+at high packing-cutoffs.
+
+As before, a daisy chain is stored as the list of its knob-keys in ascending
+order, terminated by -1 if shorter than MAX_DAISIES; two cycles which visit
+the same knobs in a different order are the same daisy chain, and the second
+is discarded by looking up the sorted list in a hash set.
+
 */
 
 
 #include "socket.h"
+#include <stdlib.h>
 
-/* this subroutine is intended to be called like this:
-
-order_of_knob_k = check_daisy_chain(k,0,daisy_chain_2Darray[n],direction);
-
--where daisy_chain_2Darray is a two dimensional array, each
-element of which corresponds to a single daisy chain and is an array
-storing the serial numbers of all the knobs which are part of that
-daisy chain. So, n is the daisy chain serial number;
-daisy_chain_2Darray[n] is a 1D array storing the knob IDs of the
-members of the nth daisy chain in the list.
-When the above call is made, daisy_chain_2Darray[n] should be
-blank (initialized to -1 values).
-
-The daisy_chain_2Darray[n] of the call is therefore equivalent
-to the daisy_chain array in the check_daisy_chain function
-
-direction is either 1 or -1, determining in what order to check
-the 2 sides of a hole (see note 8-12-99 below)
-
-The check_daisy_chain function updates the daisy_chain array
-by calling itself recursively.
-
-When called, the function does the following things:
-
-	it adds knob k to the next free element of the
-		daisy_chain array; the current size of the
-		array is held in the variable order, which is
-		zero when the function is first called externally
-
-	it increments the size of the daisy_chain array by one
-
-	it checks the two residues which form the two sides of the
-		hole into which knob k fits.
-		(All the knobs are held in the global array knob;
-		the global variable knob_index is how many
-		knobs there are; hole residues are stored in
-		global array hole[][])
-		These two residues are the second and third of the
-		four residues in the hole array, ie hole[k][1] and
-		hole[k][2].
-
-		If either of these two hole residues are themselves
-		knobs, which *fit into holes in a helix OTHER than
-		the one of which knob k is part*, then this indicates
-		that knobs k and the new knob (call it k2) form a link
-		in a 'chain' of knobs.
-
-		That is, knob k fits into a hole, the sides of which
-		are k2 and h2 (h2 is a side of k's hole which is not a
-		knob, or at least not in this knob-chain), and k2 fits
-		into a hole whose sides are k3 and h3; and neither
-		k3 nor h3 are knob k. This sort of arrangement usually
-		only occurs in cyclic (closed) chains of knobs.
-
-		(If either k3 or h3 were in fact k, then this would
-		simply represent a pairwise complementary interaction,
-		ie order 2. This function is not concerned with these.)
-
-		If k2 turns out to be first knob in the daisy_chain
-		array (this can only happen in the first *recursive* call
-		of the function or later), then the circle is complete,
-		and the function terminates by returning the order. Eg
-		the chain is: k -> k2 -> k3 -> k4 -> k -> k2 -> k3 -> k4...
-		ie the order is 4 and the elements of the array are:
-		daisy_chain[0] = k; daisy_chain[1] = k2;
-		daisy_chain[2] = k3; daisy_chain[3] = k4. 
-
-		If k2 is in fact any other knob in the daisy_chain
-		array, then the chain is 'partially cyclic' ie it goes
-		k -> k2 -> k3 -> k4 -> k2 -> k3 -> k4 -> k2 -> k3 -> k4...
-		- so k1 leads into the chain but is not actually part
-		of the cycle. If this is the case, the function terminates
-		with a negative (null) value - there is no point in dealing
-		with the daisy chain here, because the cyclic portion will
-		be dealt with elsewhere (when the function is called
-		externally to check knob k2).
-
-		If k2 is not already in the daisy_chain array, then the
-		function calles itself recursively, to check k2 in the
-		same way that k has been checked:
-		check_daisy_chain(k2,order,daisy_chain)
-
-	if neither of the two residues forming the sides of k's hole are
-		themselves knobs which fit into a hole in a helix other
-		than that of which k is part, then the function terminates
-		with a negative (null) value.
-
-
-Therefore, the recursion will end when either a negative (null) value, or
-the order of a complete, cyclic daisy chain, is returned.
+static int	component[MAX_KNOBS],	/* strongly connected component of
+					each knob (indexed by knob-key) */
+		component_size[MAX_KNOBS],	/* number of knobs in each
+						component */
+		daisy_hash[DAISY_HASH_SIZE];	/* hash set of daisy chains:
+						daisy-chain-key, or -1 if the
+						slot is empty */
 
-*/
 
-int check_daisy_chain(int thisknob, int order, int daisy_chain[], int direction)
+void build_knob_graph()
 	{
+	int i,k,k2,r,g,n_links;
 
-	int g,h,i,j,result;
+	n_links = 0;
+	for (k = 0; k < knob_index; k++)
+		{
+		knob_link_start[k] = n_links;
+		for (g = 1; g < 3; g++)
+			{
+			r = knob[k].hole[g];
+			for (i = residue_knob_start[r]; i < residue_knob_start[r+1]; i++)
+				{
+				k2 = residue_knob[i];
 
-	result = -1;
+				/* check that k2's hole is not in the helix of k */
+				if (helix_no[knob[k2].hole[0]] != helix_no[knob[k].residue])
+					{
+					if (n_links == MAX_KNOB_LINKS)
+						{
+						printf("Maximum number of knob-into-hole links (%d) exceeded\n",MAX_KNOB_LINKS);
+						exit(1);
+						}
+					knob_link[n_links++] = k2;
+					}
+				}
+			}
+		}
+	knob_link_start[knob_index] = n_links;
+
+	if (setflag[flag_debug])
+		for (k = 0; k < knob_index; k++)
+			{
+			printf("knob %d links to:",k);
+			for (i = knob_link_start[k]; i < knob_link_start[k+1]; i++)
+				printf(" %d",knob_link[i]);
+			printf("\n");
+			}
+	}
 
-	daisy_chain[order++] = thisknob;
 
-	/* f = (x+1+ (d-1)*(2x-1)/2)*/
+/* the strongly connected components of the knob-into-hole graph, by Tarjan's
+algorithm (SIAM J Comput v1 pp146-60, 1972); written without recursion, as
+the search can be as deep as there are knobs */
 
-	for (g = 0; g < 2; g++)
+static void find_components()
+	{
+	static int	visit[MAX_KNOBS], lowlink[MAX_KNOBS], on_stack[MAX_KNOBS],
+			stack[MAX_KNOBS], call_knob[MAX_KNOBS], call_link[MAX_KNOBS];
+	int k,v,w,top,depth,visits,components;
+
+	for (k = 0; k < knob_index; k++) { visit[k] = -1; on_stack[k] = false; }
+
+	visits = 0; top = 0; components = 0;
+
+	for (k = 0; k < knob_index; k++)
 		{
-		h = g + 1 + ((direction - 1) * (2*g - 1)/2);
-		for (i = 0; i < knob_index; i++)
+		if (visit[k] != -1) continue;
+
+		depth = 0;
+		call_knob[0] = k;
+		call_link[0] = knob_link_start[k];
+		visit[k] = lowlink[k] = visits++;
+		stack[top++] = k; on_stack[k] = true;
+
+		while (depth >= 0)
 			{
-			if (knob[i] == hole[thisknob][h])
+			v = call_knob[depth];
+			if (call_link[depth] < knob_link_start[v+1])
 				{
-
-				/* check that knob[i]'s hole is not in the
-				helix of previousknob */
-				if (helix_no[hole[i][0]] != 
-					helix_no[knob[thisknob]])
+				w = knob_link[call_link[depth]++];
+				if (visit[w] == -1)
 					{
+					visit[w] = lowlink[w] = visits++;
+					stack[top++] = w; on_stack[w] = true;
+					call_knob[++depth] = w;
+					call_link[depth] = knob_link_start[w];
+					}
+				else if (on_stack[w] && (visit[w] < lowlink[v]))
+					lowlink[v] = visit[w];
+				}
+			else
+				{
+				if (lowlink[v] == visit[v])
+					{
+					/* v is the root of a component */
+					component_size[components] = 0;
+					do	{
+						w = stack[--top];
+						on_stack[w] = false;
+						component[w] = components;
+						component_size[components]++;
+						} while (w != v);
+					components++;
+					}
+				if (--depth >= 0)
+					{
+					w = call_knob[depth];
+					if (lowlink[v] < lowlink[w]) lowlink[w] = lowlink[v];
+					}
+				}
+			}
+		}
+	}
 
-					j = 0;
-					while ((j < order) && (hole[i][1] != knob[daisy_chain[j]]) 
-						&& (hole[i][2] != knob[daisy_chain[j]])) j++;
 
-					if ((hole[i][1] == knob[daisy_chain[j]]) || (hole[i][2] == knob[daisy_chain[j]]))
-						{
+/* adds the cycle of knobs in daisies[0..order-1] to the GLOBAL list of daisy
+chains, unless it is already there (in a different order) */
 
-						daisy_chain[order++] = i;
-						if (j) result = -2;
-						else result = order;
-						}
-					else result = check_daisy_chain(i,order,daisy_chain,direction);
+static void add_daisy_chain(int daisies[], int order)
+	{
+	int i,j,k,slot;
+	unsigned int hash;
+	int sorted[MAX_DAISIES];
+
+	/* sort the knob-keys (insertion sort; there are very few of them) */
+	for (i = 0; i < order; i++)
+		{
+		k = daisies[i];
+		for (j = i; (j > 0) && (sorted[j-1] > k); j--) sorted[j] = sorted[j-1];
+		sorted[j] = k;
+		}
+
+	/* FNV-1a over the sorted knob-keys */
+	hash = 2166136261u;
+	for (i = 0; i < order; i++) hash = (hash ^ (unsigned int) sorted[i]) * 16777619u;
+
+	for (slot = hash & (DAISY_HASH_SIZE - 1); daisy_hash[slot] != -1;
+		slot = (slot + 1) & (DAISY_HASH_SIZE - 1))
+		{
+		j = daisy_hash[slot];
+		for (i = 0; (i < order) && (daisy_chain[j][i] == sorted[i]); i++);
+		if ((i == order) && ((order == MAX_DAISIES) || (daisy_chain[j][order] == -1)))
+			{
+			if (setflag[flag_debug])
+				printf("cycle of %d knobs from knob %d is daisy chain %d\n",order,daisies[0],j);
+			return;
+			}
+		}
+
+	if (daisy_chains == MAX_DAISY_CHAINS)
+		{
+		printf("Maximum number of daisy chains (%d) exceeded\n",MAX_DAISY_CHAINS);
+		exit(1);
+		}
+
+	for (i = 0; i < order; i++) daisy_chain[daisy_chains][i] = sorted[i];
+	daisy_hash[slot] = daisy_chains++;
+	}
+
+
+int find_daisy_chains()
+	{
+	int i,k,v,w,depth,
+		path[MAX_DAISIES],		/* the knobs of the cycle being
+						traced, from its lowest-numbered
+						knob */
+		path_link[MAX_DAISIES];		/* the next link to be followed
+						from each knob of the path */
+	static int helix_on_path[MAX_HELICES];
+
+	daisy_chains = 0;
+	for (i = 0; i < MAX_DAISY_CHAINS; i++)
+		for (k = 0; k < MAX_DAISIES; k++) daisy_chain[i][k] = -1;
+	for (i = 0; i < DAISY_HASH_SIZE; i++) daisy_hash[i] = -1;
+
+	find_components();
+
+	for (i = 0; i < helix_index; i++) helix_on_path[i] = false;
+
+	for (k = 0; k < knob_index; k++)
+		{
+		/* the unpruned search (--legacy) follows every path from every
+		knob, whatever its component, and so finds each cycle once for
+		each of its knobs, all but the first being discarded as
+		duplicates */
+		if (!setflag[flag_legacy] && (component_size[component[k]] < 3)) continue;
+
+		depth = 0;
+		path[0] = k;
+		path_link[0] = knob_link_start[k];
+		helix_on_path[helix_no[knob[k].residue]] = true;
+
+		while (depth >= 0)
+			{
+			v = path[depth];
+			if (path_link[depth] < knob_link_start[v+1])
+				{
+				work_count[count_daisy_steps]++;
+				w = knob_link[path_link[depth]++];
+				if (w == k)
+					{
+					/* back to the first knob: a closed chain */
+					if (depth >= 2) add_daisy_chain(path,depth+1);
+					}
+				else if ((setflag[flag_legacy] || ((w > k) && (component[w] == component[k])))
+					&& !helix_on_path[helix_no[knob[w].residue]] && (depth < MAX_DAISIES - 1))
+					{
+					path[++depth] = w;
+					path_link[depth] = knob_link_start[w];
+					helix_on_path[helix_no[knob[w].residue]] = true;
 					}
 				}
-			if (result != -1) break;
+			else
+				{
+				helix_on_path[helix_no[knob[v].residue]] = false;
+				depth--;
+				}
 			}
-		if (result != -1) break;
 		}
-	return result;
+
+	return daisy_chains;
 	}
 
 
+/* The notes below were written for check_daisy_chain(), the recursive tracer
+which find_daisy_chains() replaced: it followed a single path of knobs from each
+knob in turn, taking the two sides of each hole in one order and then the
+other. They record the structures (1aik, 1ebo) in which that path missed a
+daisy chain, or ran into one of which its first knob was not part. */
+
 /*
 eg 1aik at cutoff 8.2
 
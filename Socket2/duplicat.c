@@ -33,54 +33,39 @@ the PDB file.
 
 #include "socket.h"
 #include <string.h>
+/* the knobs of each residue are already listed together, in order of knob-key,
+by index_knobs(); a residue with more than one is a set of duplicates, and it is
+found when its first (lowest) knob is reached, so the sets come out in the same
+order as when each knob was compared with every later one */
+
 void check_duplication()
 	{
-	int i,j,copies,checked[MAX_KNOBS];
-
-	/* the checked[] array is so that each knob appears only once in the
-	duplicates table at most*/
-	for (i = 0; i < knob_index; i++) checked[i] = 0;
-
-	/* initialize duplicates table (global) */
-	for (i = 0; i < MAX_DUPLICATES; i++)
-		for (j = 0; j < 3; j++) duplicate_knobs[i][j] = -1;
+	int i,j,k,r;
 
 	/* global */
 	n_duplicate_knobs = 0;
 
-
-	for (i = 0; i < knob_index - 1; i++)
+	for (k = 0; k < knob_index; k++)
 		{
-		/* for each set of duplicates, this is how many there are
-		(should be no more than 2 */
-		copies = 0;
-
-		for (j = i+1; j < knob_index; j++)
-			if ((!checked[j]) && (knob[i] == knob[j]))
-				{
-				if (!copies) {
-					if (copies == 3)
-						{
-						printf("too many knob duplicates: knobs %d, %d, %d, %d are all residue %d (%s %d:%c, iCode='%c') ; only 3 knob duplicates can be stored; is your specified cutoff too high?\n\n",
-duplicate_knobs[n_duplicate_knobs][0],duplicate_knobs[n_duplicate_knobs][1],duplicate_knobs[n_duplicate_knobs][2],j,knob[i],helix_residue_name[knob[i]],helix_residue_no[knob[i]],helix_chain[helix_no[knob[i]]],helix_residue_iCode[knob[i]]);
-					exit(1);
-					}
-					printf("duplicate knobs: %3d",i);
-					duplicate_knobs[n_duplicate_knobs][copies++] = i;
-					}
-				printf(",%3d",j);
-				duplicate_knobs[n_duplicate_knobs][copies++] = j;
-				checked[j] = 1;
-				}
-		if (copies) {printf("\n"); n_duplicate_knobs++;}
+		r = knob[k].residue;
+		if ((residue_knob[residue_knob_start[r]] == k)
+			&& (residue_knob_start[r+1] - residue_knob_start[r] > 1))
+			{
+			printf("duplicate knobs: %3d",k);
+			for (i = residue_knob_start[r] + 1; i < residue_knob_start[r+1]; i++)
+				printf(",%3d",residue_knob[i]);
+			printf("\n");
+			duplicate_residue[n_duplicate_knobs++] = r;
+			}
 		}
 
 	if (n_duplicate_knobs > 0) printf("sets of duplicate knobs:\n");
 	for (i = 0; i < n_duplicate_knobs; i++)
 		{
+		r = duplicate_residue[i];
 		printf("%2d)",i);
-		j = 0; while ((j < 3) && (duplicate_knobs[i][j] != -1)) printf(" %3d",duplicate_knobs[i][j++]);
-		j = duplicate_knobs[i][0];
-		printf("\tare all residue %d (%s %d:%c, iCode='%c')\n",knob[j],helix_residue_name[knob[j]],helix_residue_no[knob[j]],helix_chain[helix_no[knob[j]]],helix_residue_iCode[knob[i]]);
+		for (j = residue_knob_start[r]; j < residue_knob_start[r+1]; j++)
+			printf(" %3d",residue_knob[j]);
+		printf("\tare all residue %d (%s %d:%c, iCode='%c')\n",r,helix_residue_name[r],helix_residue_no[r],helix_chain[helix_no[r]],helix_residue_iCode[r]);
 		}
 	}
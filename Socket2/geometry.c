@@ -44,9 +44,9 @@ float packing_angle(int knobres, int holeres1, int holeres2)
 	magnitudeA = 0; magnitudeB = 0; result = 0;
 	for (i = 0; i < 3; i++)
 		{
-		A[i] = coord[refatom3[knobres]][i] - coord[refatom0[knobres]][i];
+		A[i] = residue_geometry[knobres].cb[i] - residue_geometry[knobres].ca[i];
 		magnitudeA += A[i]*A[i];
-		B[i] = coord[refatom0[holeres1]][i] - coord[refatom0[holeres2]][i];
+		B[i] = residue_geometry[holeres1].ca[i] - residue_geometry[holeres2].ca[i];
 		magnitudeB += B[i]*B[i];
 /*printf("A[%d] = %8.3f, B[%d] = %8.3f\n",i,A[i],i,B[i]);*/
 		}
@@ -57,17 +57,105 @@ float packing_angle(int knobres, int holeres1, int holeres2)
 	return 180.0 * acosf(result/(magnitudeA * magnitudeB)) / M_PI;
 	}
 
-void determine_centre_of_mass(int atom_index)
+/* which classes of atom count towards the 'centre of mass'; the alpha-carbon
+(and its hydrogens) only if -i is set */
+
+static enum boolean in_side_chain[ATOM_CLASS_MASK + 1];
+
+static void set_side_chain_classes()
+	{
+	int i;
+
+	for (i = 0; i <= ATOM_CLASS_MASK; i++) in_side_chain[i] = true;
+	in_side_chain[atom_backbone] = false;
+	in_side_chain[atom_CA] = in_side_chain[atom_HA] = setflag[flag_i];
+	}
+
+
+/* when -m is set, the atoms are not kept, and what is needed of them is
+gathered here as they are read: the sum of each residue's side chain atoms is
+accumulated in refatom2[] (and divided by side_chain_atoms[] in
+determine_centre_of_mass()), the alpha- and beta-carbons go straight into
+residue_geometry[], and the end-atoms are held in end_atom[] until
+determine_end() */
+
+static int	side_chain_atoms[MAX_RESIDUES];	/* the number of atoms summed
+						in refatom2[] */
+static float	end_atom[MAX_RESIDUES][2][3],	/* the coordinates of the atoms
+						refatom1[0..1]; if there is no
+						first end-atom, [0] is the last
+						atom read of the residue, which
+						determine_end() falls back on */
+		first_atom[3];			/* atom 0, which stands in for a
+						missing beta-carbon (refatom3
+						is 0 by default) */
+
+void stream_atom(int atom, int residue, int class, float x, float y, float z)
+	{
+	int j;
+	float xyz[3];
+
+	xyz[0] = x; xyz[1] = y; xyz[2] = z;
+
+	if (atom == 0)
+		{
+		set_side_chain_classes();
+		for (j = 0; j < 3; j++) first_atom[j] = xyz[j];
+		}
+
+	if (in_side_chain[class & ATOM_CLASS_MASK])
+		{
+		if (side_chain_atoms[residue]++)
+			for (j = 0; j < 3; j++) refatom2[residue][j] += xyz[j];
+		else	for (j = 0; j < 3; j++) refatom2[residue][j] = xyz[j];
+		}
+
+	if (class & atom_end1)
+		for (j = 0; j < 3; j++) end_atom[residue][0][j] = xyz[j];
+	else if (class & atom_end2)
+		for (j = 0; j < 3; j++) end_atom[residue][1][j] = xyz[j];
+	else if (refatom1[0][residue] == -1)
+		for (j = 0; j < 3; j++) end_atom[residue][0][j] = xyz[j];
+
+	if (refatom0[residue] == atom)
+		for (j = 0; j < 3; j++) residue_geometry[residue].ca[j] = xyz[j];
+	if (refatom3[residue] == atom)
+		for (j = 0; j < 3; j++) residue_geometry[residue].cb[j] = xyz[j];
+	}
+
+
+/* the coordinates of end-atom j (0 or 1) of residue res */
+
+static float *end_atom_coord(int j, int res)
+	{
+	return setflag[flag_m] ? end_atom[res][j] : coord[refatom1[j][res]];
+	}
+
+
+void determine_centre_of_mass(int residue_index, int atom_index)
 	{
 	int i, j, last_residue_index, n_atoms;
+
+	if (setflag[flag_m])
+		{
+		for (i = 0; i < residue_index; i++)
+			if (side_chain_atoms[i])
+				{
+				for (j = 0; j < 3; j++) refatom2[i][j] /= side_chain_atoms[i];
+				if (setflag[flag_debug]) printf("centre of mass of residue %d (%d atoms): %8.3f , %8.3f , %8.3f\n",
+					i,side_chain_atoms[i],refatom2[i][0],refatom2[i][1],refatom2[i][2]);
+				}
+		return;
+		}
+
+	set_side_chain_classes();
+
 	last_residue_index = -1;
 	n_atoms = 0;
 	for (i = 0; i < atom_index; i++)
 		if (atom_res[i] != last_residue_index)
 			{
-			if (strcmp(atom_name[i]," N  ") && strcmp(atom_name[i]," C  ") && strcmp(atom_name[i]," O  ") && 
-((setflag[flag_i]) || strcmp(atom_name[i]," CA "))  && (setflag[flag_i] || (strcmp(atom_name[i]," HA ") && 
-strcmp(atom_name[i],"1HA ") && strcmp(atom_name[i],"2HA ") ) ) ) 
+			if (in_side_chain[atom_class[i] & ATOM_CLASS_MASK])
 				{
 				if (last_residue_index != -1)
 					{for (j = 0; j < 3; j++) refatom2[last_residue_index][j] /= n_atoms;
@@ -79,9 +167,7 @@ refatom2[last_residue_index][0],refatom2[last_residue_index][1],refatom2[last_re
 				for (j = 0; j < 3; j++) refatom2[last_residue_index][j] = coord[i][j];
 				}
 			}
-		else if (strcmp(atom_name[i]," N  ") && strcmp(atom_name[i]," C  ") && strcmp(atom_name[i]," O  ") && 
-((setflag[flag_i]) || strcmp(atom_name[i]," CA "))  && (setflag[flag_i] || (strcmp(atom_name[i]," HA ") && 
-strcmp(atom_name[i],"1HA ") && strcmp(atom_name[i],"2HA ") ) ) ) 
+		else if (in_side_chain[atom_class[i] & ATOM_CLASS_MASK])
 			{
 			if (setflag[flag_debug]) printf("\tadding atom %d \"%s\" to residue (%d)\n",i,atom_name[i],atom_res[i]);
 			n_atoms++;
@@ -102,13 +188,13 @@ void determine_end(int residue_index, int atom_index)
 
 		n_atoms = 0;
 
-		for (k = 0; k < 3; k++) refatom1B[i][k] = 0.0;
+		for (k = 0; k < 3; k++) residue_geometry[i].end[k] = 0.0;
 
 		for (j = 0; j < 2; j++)
 			if (refatom1[j][i] != -1)
 				{
 				n_atoms++;
-				for (k = 0; k < 3; k++) refatom1B[i][k] += coord[refatom1[j][i]][k];
+				for (k = 0; k < 3; k++) residue_geometry[i].end[k] += end_atom_coord(j,i)[k];
 				}
 
 		if (!n_atoms)
@@ -117,44 +203,174 @@ void determine_end(int residue_index, int atom_index)
 					i, helix_residue_name[i],helix_residue_no[i],
 				helix_chain[helix_no[i]], helix_residue_iCode[i]); 
 
-				for (k = 0; k < atom_index; k++)
+				if (setflag[flag_m])
 					{
-					if (setflag[flag_debug])
-						printf("atom_res[%d] (of %d) is %d, vs residue %d\n",
-						k,atom_index,atom_res[k],i);
-					if (atom_res[k] == i) refatom1[0][i] = k;
-					if (atom_res[k] > i) break;
-					}
+					/* the last atom of the residue, kept by stream_atom() */
+					for (k = 0; k < 3; k++) residue_geometry[i].end[k] = end_atom[i][0][k];
 
-				for (k = 0; k < 3; k++) refatom1B[i][k] = coord[refatom1[0][i]][k];
+					printf("Using the last atom read (%s %d%c iCode='%c') as end atom for this residue\n",
+					helix_residue_name[i],helix_residue_no[i],helix_chain[helix_no[i]],
+					helix_residue_iCode[i]);
+					}
+				else
+					{
+					for (k = 0; k < atom_index; k++)
+						{
+						if (setflag[flag_debug])
+							printf("atom_res[%d] (of %d) is %d, vs residue %d\n",
+							k,atom_index,atom_res[k],i);
+						if (atom_res[k] == i) refatom1[0][i] = k;
+						if (atom_res[k] > i) break;
+						}
+
+					for (k = 0; k < 3; k++) residue_geometry[i].end[k] = coord[refatom1[0][i]][k];
+
+					printf("Using atom %d (%s %d%c iCode='%c' %s) as end atom for this residue\n", refatom1[0][i],
+					helix_residue_name[i],helix_residue_no[i],helix_chain[helix_no[i]],
+					helix_residue_iCode[i],atom_name[refatom1[0][i]]);
+					}
 
 				n_atoms++;
+				}
 
-				printf("Using atom %d (%s %d%c iCode='%c' %s) as end atom for this residue\n", refatom1[0][i],
-				helix_residue_name[i],helix_residue_no[i],helix_chain[helix_no[i]],
-				helix_residue_iCode[i],atom_name[refatom1[0][i]]);
+		if (n_atoms > 1) for (k = 0; k < 3; k++) residue_geometry[i].end[k] /= n_atoms;
 
+		/* the alpha- and beta-carbons are copied alongside the end, for
+		classifying knobs (a residue without a beta-carbon has refatom3
+		of 0, as before); with -m, stream_atom() has copied them already */
+		if (setflag[flag_m])
+			for (k = 0; k < 3; k++)
+				{
+				if (refatom0[i] == -1) residue_geometry[i].ca[k] = 0.0;
+				if (refatom3[i] == 0) residue_geometry[i].cb[k] = first_atom[k];
 				}
-
-		if (n_atoms > 1) for (k = 0; k < 3; k++) refatom1B[i][k] /= n_atoms;
+		else for (k = 0; k < 3; k++)
+			{
+			residue_geometry[i].ca[k] = (refatom0[i] != -1) ? coord[refatom0[i]][k] : 0.0;
+			residue_geometry[i].cb[k] = coord[refatom3[i]][k];
+			}
 
 		if (setflag[flag_debug]) printf("residue %d (%s %d:%c iCode='%c') end (pseudo)atom: %8.3f , %8.3f , %8.3f\n", 
 		i, helix_residue_name[i],helix_residue_no[i], helix_chain[helix_no[i]],
-		helix_residue_iCode[i], refatom1B[i][0], refatom1B[i][1], refatom1B[i][2]);
+		helix_residue_iCode[i], residue_geometry[i].end[0], residue_geometry[i].end[1], residue_geometry[i].end[2]);
+		}
+	}
+
+void determine_helix_axes(int residue_index)
+	{
+	int h, i, j, k, r, n_points;
+	float chord[3], centre[3], point[3], cov[3][3], v[3], w[3], magnitude;
+
+	for (h = 0; h < helix_index; h++)
+		{
+		helix_N_residue[h] = -1;
+		helix_C_residue[h] = -1;
+		}
+
+	/* the terminal residues of each helix are found in a single pass */
+	for (r = 0; r < residue_index; r++)
+		{
+		h = helix_no[r];
+		if ((helix_residue_no[r] == helix_start[h]) &&
+			(helix_residue_iCode[r] == helix_start_iCode[h]))
+			helix_N_residue[h] = r;
+		if ((helix_residue_no[r] == helix_end[h]) &&
+			(helix_residue_iCode[r] == helix_end_iCode[h]))
+			helix_C_residue[h] = r;
+		}
+
+	for (h = 0; h < helix_index; h++)
+		{
+		for (i = 0; i < 3; i++) helix_axis[h][i] = 0.0;
+		if ((helix_N_residue[h] == -1) || (helix_C_residue[h] == -1)) continue;
+
+		/* the crude axis, from the reference atom (0) (i.e. alpha-carbon) of
+		the N-terminal residue to that of the C-terminal residue */
+		for (i = 0; i < 3; i++)
+			chord[i] = residue_geometry[helix_C_residue[h]].ca[i] - residue_geometry[helix_N_residue[h]].ca[i];
+		for (i = 0; i < 3; i++) helix_axis[h][i] = chord[i];
+
+		if (setflag[flag_x])
+			{
+			/* the least-squares axis: the principal axis of the points
+			midway between the alpha-carbons of each 4 consecutive residues
+			(which lie close to the helix axis, as there are 3.6 residues
+			per turn); found by power iteration, starting from the crude
+			axis */
+			n_points = 0;
+			for (i = 0; i < 3; i++)
+				{
+				centre[i] = 0.0;
+				for (j = 0; j < 3; j++) cov[i][j] = 0.0;
+				}
+			for (r = helix_N_residue[h]; r + 3 <= helix_C_residue[h]; r++)
+				{
+				for (k = 0; (k < 4) && (helix_no[r+k] == h) && (refatom0[r+k] != -1); k++);
+				if (k < 4) continue;
+				for (i = 0; i < 3; i++)
+					{
+					point[i] = 0.0;
+					for (k = 0; k < 4; k++) point[i] += residue_geometry[r+k].ca[i];
+					point[i] /= 4.0;
+					centre[i] += point[i];
+					for (j = 0; j <= i; j++) cov[i][j] += point[i] * point[j];
+					}
+				n_points++;
+				}
+
+			if (n_points >= 2)
+				{
+				for (i = 0; i < 3; i++) centre[i] /= n_points;
+				for (i = 0; i < 3; i++)
+					for (j = 0; j <= i; j++)
+						{
+						cov[i][j] = cov[i][j] / n_points - centre[i] * centre[j];
+						cov[j][i] = cov[i][j];
+						}
+				for (i = 0; i < 3; i++) v[i] = chord[i];
+				for (k = 0; k < 50; k++)
+					{
+					magnitude = 0.0;
+					for (i = 0; i < 3; i++)
+						{
+						w[i] = 0.0;
+						for (j = 0; j < 3; j++) w[i] += cov[i][j] * v[j];
+						magnitude += w[i] * w[i];
+						}
+					if (magnitude == 0.0) break;
+					magnitude = sqrt(magnitude);
+					for (i = 0; i < 3; i++) v[i] = w[i] / magnitude;
+					}
+				if (k == 50)
+					{
+					/* keep the N- to C-terminal sense of the crude axis */
+					magnitude = 0.0;
+					for (i = 0; i < 3; i++) magnitude += v[i] * chord[i];
+					for (i = 0; i < 3; i++) helix_axis[h][i] = (magnitude < 0.0) ? -v[i] : v[i];
+					}
+				}
+			}
+
+		magnitude = 0.0;
+		for (i = 0; i < 3; i++) magnitude += helix_axis[h][i] * helix_axis[h][i];
+		magnitude = sqrt(magnitude);
+		if (magnitude > 0.0) for (i = 0; i < 3; i++) helix_axis[h][i] /= magnitude;
+
+		if (setflag[flag_debug]) printf("helix %d (residues %d..%d) axis: %8.5f , %8.5f , %8.5f\n",
+			h, helix_N_residue[h], helix_C_residue[h],
+			helix_axis[h][0], helix_axis[h][1], helix_axis[h][2]);
 		}
 	}
 
-void measure_helix_pair(int helix1, int helix2, int residue_index)
+void measure_helix_pair(int helix1, int helix2)
 	{
 	int i,j;
 	if (setflag[flag_v] || setflag[flag_l])
 		printf("- contacts between helix %3d v helix %3d\n\n",
 			helix1,helix2);
-	for (i = 0; i < residue_index; i++)
-		if (helix_no[i] == helix1)
-			for (j = 0; j < residue_index; j++)
-				if (helix_no[j] == helix2)
-					measure_residue_pair(i,j);
+	for (i = helix_residue_start[helix1]; i < helix_residue_start[helix1+1]; i++)
+		for (j = helix_residue_start[helix2]; j < helix_residue_start[helix2+1]; j++)
+			measure_residue_pair(helix_residue[i],helix_residue[j]);
 	if (setflag[flag_v] || setflag[flag_l])
 		printf("- done contacts helix %3d v helix %3d\n\n",
 			helix1,helix2);
@@ -163,6 +379,7 @@ void measure_helix_pair(int helix1, int helix2, int residue_index)
 void measure_residue_pair(int res1, int res2)
 	{
 	float CA_distance, centre_distance, end_distance;
+	work_count[count_residue_pairs]++;
 	if (setflag[flag_v] || setflag[flag_l])
 		CA_distance = measure_CA_distance(res1,res2);
 	centre_distance = measure_centre_distance(res1,res2);
@@ -187,7 +404,15 @@ void measure_residue_pair(int res1, int res2)
 
 void add_contact(int res1, int res2, float distance)
 	{
-	if (++n_contacts[res1] > 4)
+	if (n_contacts[res1] == MAX_CONTACTS)
+		{
+		if (setflag[flag_v] || setflag[flag_l])
+			printf("residue %4d already has %d contacts; contact with residue %4d ignored\n",
+				res1, MAX_CONTACTS, res2);
+		return;
+		}
+
+	if ((++n_contacts[res1] > 4) && (setflag[flag_v] || setflag[flag_l]))
 		printf("%d sidechains in contact with residue %4d (%s %5d:%c, iCode='%c' helix %3d)\n",
 			n_contacts[res1], res1, helix_residue_name[res1],
 			helix_residue_no[res1], helix_chain[helix_no[res1]],
@@ -195,11 +420,13 @@ void add_contact(int res1, int res2, float distance)
 	
 	contact[res1][n_contacts[res1]-1] = res2;
 	contact_distance[res1][n_contacts[res1]-1] = distance;
+	work_count[count_contacts]++;
+	if (n_contacts[res1] > contacts_high_water) contacts_high_water = n_contacts[res1];
 	}
 
 float measure_CA_distance(int res1, int res2)
 	{
-	return distance(coord[refatom0[res1]],coord[refatom0[res2]]);
+	return distance(residue_geometry[res1].ca,residue_geometry[res2].ca);
 	}
 
 void measure_end_distance(int res1, int res2)
@@ -209,12 +436,12 @@ void measure_end_distance(int res1, int res2)
 		if (refatom1[i][res1] != -1)
 			for (j = 0; j < 2; j++)
 				if ((refatom1[j][res2] != -1) /* && (setflag[flag_v] || setflag[flag_l])*/ )
-					printf("\t(%d,%d): %8.3f\n", i,j,distance(coord[refatom1[i][res1]],coord[refatom1[j][res2]]));
+					printf("\t(%d,%d): %8.3f\n", i,j,distance(end_atom_coord(i,res1),end_atom_coord(j,res2)));
 	}
 
 float measure_end_distance_B(int res1, int res2)
 	{
-	return distance(refatom1B[res1],refatom1B[res2]);
+	return distance(residue_geometry[res1].end,residue_geometry[res2].end);
 	}
 
 float measure_centre_distance(int res1, int res2)
@@ -231,11 +458,30 @@ float measure_k_end_h_CA(int knobid)
 	d = 0;
 	for (i = 0; i < 4; i++)
 		{
-		d += distance(refatom1B[knob[knobid]],coord[refatom0[hole[knobid][i]]]);
+		d += distance(residue_geometry[knob[knobid].residue].end,residue_geometry[knob[knobid].hole[i]].ca);
 		}
 	return d/4.0;
 	}
 
+void measure_knob(int knobid)
+	{
+	int i;
+	int *hole = knob[knobid].hole;
+	struct knob_geometry *g = &knob_geometry[knobid];
+
+	/* JW 13-7-6: the distances of the knob from its hole residues are those of
+	its first 4 contacts */
+	for (i = 0; i < 4; i++) g->hole_distance[i] = contact_distance[knob[knobid].residue][i];
+
+	g->side[0] = measure_centre_distance(hole[0],hole[1]);
+	g->side[1] = measure_centre_distance(hole[0],hole[2]);
+	g->side[2] = measure_centre_distance(hole[1],hole[3]);
+	g->side[3] = measure_centre_distance(hole[2],hole[3]);
+
+	g->end_distance = measure_k_end_h_CA(knobid);
+	g->angle = packing_angle(knob[knobid].residue,hole[1],hole[2]);
+	}
+
 float distance(float coords1[], float coords2[])
 	{
 	int i;
@@ -51,10 +51,21 @@ available parameters, and the third a boolean type; N.B. the actual names of
 the flags/parameters the user specifies on the command-line are defined in
 flagname[] and parname[] */
 
-enum flags {flag_debug,flag_a,flag_b,flag_i,flag_l,flag_p,flag_q,flag_u,flag_v};
-enum pars {par_c,par_d,par_e,par_f,par_j,par_k,par_o,par_r,par_s,par_t,par_w};
+enum flags {flag_debug,flag_a,flag_b,flag_i,flag_l,flag_m,flag_p,flag_q,flag_T,flag_u,flag_v,flag_x,
+	flag_perf,flag_mem_report,flag_legacy};
+enum pars {par_c,par_d,par_e,par_f,par_j,par_J,par_k,par_K,par_o,par_r,par_s,par_t,par_w,
+	par_trace,par_trace_min,par_serve,par_workers};
 enum boolean {false,true};
 
+/* the stages of the analysis, and the counts of work done, reported by -T (see
+profile.c) */
+
+enum stages {stage_dssp,stage_pdb,stage_centres,stage_ends,stage_axes,stage_contacts,
+	stage_knobs,stage_complementarity,stage_duplication,stage_order,stage_register,stage_write,
+	STAGES};
+enum counts {count_helix_pairs,count_residue_pairs,count_contacts,count_knobs,
+	count_daisy_steps,count_coiled_coils,COUNTS};
+
 /* flags:
 	debug	- writes out loads of very verbose info
 	a	- use all atoms, not just heavy (ie include hydrogens if any),
@@ -65,13 +76,39 @@ enum boolean {false,true};
 	i	- include C-alphas as part of a side chain
 	l	- list all the knob-hole interactions and knob complementarity
 			- and numerous other details
+	m	- don't keep the atoms: the side chain centres, ends, and
+			alpha- and beta-carbons of each residue are gathered
+			as the PDB file is read, which saves most of the memory
+			on very large structures (MAX_ATOMS no longer applies)
 	p	- 'private' output - names of input/output files are not
 			mentioned
 	q	- 'quiet' output
+	T	- report the time spent in each stage of the analysis, and
+			counts of the work done, on one line (see profile.c)
 	u	- check unmatched heterogen names against a list of known
 		  heterogens
 	v	- verbose output - lists the helices, the helical residues
 		  and their centres of volume and ends; and many other details
+	x	- fit each helix axis by least squares, rather than taking
+		  the line from the first to the last alpha-carbon, when
+		  assessing the orientation of pairs of helices
+	-perf	- (i.e. --perf) report the hardware performance counters
+			(cycles, instructions, cache and branch misses) of
+			each stage of the analysis, and per residue pair of
+			the knobs-into-holes search, on lines beginning PERF;
+			Linux only, and only where the counters are allowed
+			(see profile.c)
+	-mem-report - (i.e. --mem-report) report, for each major structure
+			(atoms, residues, contacts, helices, knobs, daisy
+			chains, coiled coils, registers), the bytes used by
+			the entry against the bytes reserved, and the peak
+			resident set size, on lines beginning MEMORY (see
+			memory.c)
+	-legacy	- (i.e. --legacy) use the legacy (unoptimized) engines for
+			the contact search and the choice of holes, and the
+			daisy chain search without its pruning, which must
+			give exactly the same results as the usual ones (see
+			legacy.c)
 
 parameters:
 	c	- packing-cutoff (ngstroms)
@@ -81,10 +118,20 @@ parameters:
 	e	- helix extension (in residues); each helix is extended by e
 			residues at each end (if these residues exist)
 	f	- name of input PDB file (mandatory)
-	j	- NOT USED
+	j	- the number of threads used to assign registers to, and write
+			out, the coiled coils (default 1); coiled coils which
+			share a helix are done by the same thread, and the
+			output is the same whatever the number
+	J	- name of the optional JSON output file, which holds the
+			helices, residues (with their registers), knobs,
+			daisy chains and coiled coils; see json.c
 	k	- the lowest knob-type defined as complementary - should always
 			be 3 - see DEFAULT_KNOB_THRESHOLD - legacy feature,
 			don't use it!
+	K	- name of the optional knob column directory, to which one
+			row per knob is appended (entry, chain, residue,
+			knobtype, order, packing angle, hole residues and
+			distances), one file per column; see knobcols.c
 	o	- name of the optional long output file, one residue per line
 	r	- name of the optional output RasMol script file
 	s	- name of the input DSSP file (mandatory)
@@ -95,6 +142,22 @@ parameters:
 	w	- the name of the 'helix register' file; now redundant, as
 			nothing is actually written to it- legacy feature, don't
 			use it!
+	-trace	- (i.e. --trace) name of the optional trace file, a timeline
+			of the run (its stages, the slowest helix pairs and,
+			with -j, the work of each thread) in the Chrome trace-
+			event format, for Perfetto or chrome://tracing; see
+			trace.c
+	-trace-min - (i.e. --trace-min) the shortest knobs-into-holes
+			search of a helix pair, in microseconds, written to the
+			trace as a span of its own (default 1000)
+	-serve	- (i.e. --serve) name of a Unix domain socket on which to
+			serve analyses, as a daemon, instead of analysing one
+			structure; each request is analysed by a worker
+			process, and answered with a JSON document (see
+			serve.c)
+	-workers - (i.e. --workers) the number of worker processes, and so
+			of requests analysed at once, when serving (default:
+			the number of processors)
 	
 */
 
@@ -198,6 +261,28 @@ char refatom0type[5];	/* stores the actual 4-character string which represents
 			the atom-type used as reference atom (0), e.g. " CA ",
 			which is the default (see REFATOM0) */
 
+/* atom names are compared as 32-bit keys, the 4 characters of the PDB 'name'
+field packed most significant first (see atom_key() in read.c); ATOM_KEY packs a
+4-character string constant in the same way, so that tables of keys can be
+initialised at compile time */
+
+#define ATOM_KEY(s) (((unsigned int)(unsigned char)(s)[0] << 24) | \
+	((unsigned int)(unsigned char)(s)[1] << 16) | \
+	((unsigned int)(unsigned char)(s)[2] << 8) | (unsigned int)(unsigned char)(s)[3])
+
+unsigned int refatom0key;	/* refatom0type, packed as an atom key */
+
+/* the class of each atom, determined once from its name as it is read in (see
+read_helical_pdb()); the low bits are one of atom_side_chain ... atom_CB (the
+'HA' class covers " HA ", "1HA " and "2HA "), and atom_end1 and atom_end2 are
+added if the atom is respectively the first or second 'end-atom' of its residue
+(see refatomkey below) */
+
+enum atom_class {atom_side_chain,atom_backbone,atom_CA,atom_HA,atom_CB,
+	atom_end1 = 8,atom_end2 = 16};
+
+#define ATOM_CLASS_MASK 7	/* masks atom_end1 and atom_end2 off a class */
+
 int	refatom0[MAX_RESIDUES],		/* refatom0 is the list of C-alpha (or
 					REFATOM0) atoms, one for each residue,
 					referenced by index of atom array;
@@ -216,10 +301,19 @@ int	refatom0[MAX_RESIDUES],		/* refatom0 is the list of C-alpha (or
 					atom-keys */
 
 
-float	refatom1B[MAX_RESIDUES][3],	/* refatom1B is the list of coordinates
-					of the 'pseudo atom' at the end of each
-					residue's side chain. If there is only
-					one actual end atom (see above), this
+float	refatom2[MAX_RESIDUES][3];	/* refatom2 is the list of coordinates
+					of the 'centre of mass' of each
+					residue's side chain- actually mean
+					coords of each side chain atom, without
+					weighting by mass; these are all that
+					the search for contacts between helices
+					reads, so they are kept on their own */
+
+struct residue_geometry {
+	float	end[3],			/* the coordinates of the 'pseudo
+					atom' at the end of each residue's side
+					chain. If there is only one actual end
+					atom (see refatom1 above), this
 					pseudo-atom has the same coordinates as
 					this end atom. If there are two actual
 					end atoms, then the pseudo atom is the
@@ -227,33 +321,41 @@ float	refatom1B[MAX_RESIDUES][3],	/* refatom1B is the list of coordinates
 					is needed to define a single coordinate
 					of a residue's end */
 
+		ca[3],			/* the coordinates of the reference
+					atom (0), i.e. alpha-carbon */
 
-	refatom2[MAX_RESIDUES][3];	/* refatom2 is the list of coordinates
-					of the 'centre of mass' of each
-					residue's side chain- actually mean
-					coords of each side chain atom, without
-					weighting by mass */
+		cb[3];			/* the coordinates of the reference
+					atom (3), i.e. beta-carbon */
+	} residue_geometry[MAX_RESIDUES];	/* the positions needed to
+					classify a knob and its hole, copied
+					together by determine_end(), so that
+					they are not gathered from coord[] by
+					way of refatom0[], refatom1[] and
+					refatom3[] */
 
 
 
 /* order of amino acids in type "enum amino_acid" is:
  {X,A,C,D,E,F,G,H,I,K,L,M,N,P,Q,R,S,T,V,W,Y} */
 
-static char *refatomtype[2][AMINO_ACIDS] = {
-				{"    ", " CB ", " SG ", " OD1", " OE1",
-					" CZ ", " CA ", " CE1", " CD1",
-					" NZ ", " CD1", " CE ", " OD1",
-					" CG ", " OE1", " NH1", " OG ",
-					" OG1", " CG1", " CH2", " OH " },
-				{"    ", "    ", "    ", " OD2", " OE2",
-					"    ", "    ", " NE2", "    ",
-					"    ", " CD2", "    ", " ND2",
-					"    ", " NE2", " NH2", "    ",
-					" CG2", " CG2", "    ", "    "}
+static const unsigned int refatomkey[2][AMINO_ACIDS] = {
+				{ATOM_KEY("    "), ATOM_KEY(" CB "), ATOM_KEY(" SG "), ATOM_KEY(" OD1"),
+					ATOM_KEY(" OE1"), ATOM_KEY(" CZ "), ATOM_KEY(" CA "), ATOM_KEY(" CE1"),
+					ATOM_KEY(" CD1"), ATOM_KEY(" NZ "), ATOM_KEY(" CD1"), ATOM_KEY(" CE "),
+					ATOM_KEY(" OD1"), ATOM_KEY(" CG "), ATOM_KEY(" OE1"), ATOM_KEY(" NH1"),
+					ATOM_KEY(" OG "), ATOM_KEY(" OG1"), ATOM_KEY(" CG1"), ATOM_KEY(" CH2"),
+					ATOM_KEY(" OH ") },
+				{ATOM_KEY("    "), ATOM_KEY("    "), ATOM_KEY("    "), ATOM_KEY(" OD2"),
+					ATOM_KEY(" OE2"), ATOM_KEY("    "), ATOM_KEY("    "), ATOM_KEY(" NE2"),
+					ATOM_KEY("    "), ATOM_KEY("    "), ATOM_KEY(" CD2"), ATOM_KEY("    "),
+					ATOM_KEY(" ND2"), ATOM_KEY("    "), ATOM_KEY(" NE2"), ATOM_KEY(" NH2"),
+					ATOM_KEY("    "), ATOM_KEY(" CG2"), ATOM_KEY(" CG2"), ATOM_KEY("    "),
+					ATOM_KEY("    ") }
 			};
 
-/* (the refatomtype array is to identify which atoms' coordinates should be
-read into the 2 elements of refatom1) */
+/* (the refatomkey array is to identify which atoms' coordinates should be
+read into the 2 elements of refatom1; the names are held as atom keys, see
+ATOM_KEY above) */
 
 
 /* GLOBAL VARIABLES: 'relational database' of structural entities: -------------
@@ -290,6 +392,9 @@ int	atom_no[MAX_ATOMS],		/* atom serial number (PDB 'serial'
 
 char	atom_name[MAX_ATOMS][5];	/* atom name (PDB 'name' field) */
 
+unsigned char	atom_class[MAX_ATOMS];	/* the class of the atom, from its name
+						and residue type (enum atom_class) */
+
 float	coord[MAX_ATOMS][3];		/* orthogonal coordinates of atom
 						(PDB 'x', 'y' and 'z' fields) */
 
@@ -326,12 +431,13 @@ int	helix_residue_no[MAX_RESIDUES], /* residue sequence number (PDB
 					separated by no more than the packing-
 					cutoff */
 
-	contact[MAX_RESIDUES][10];	/* the n_contacts contacts are stored
-					here; up to 10 contacts can be stored,
-					but if there are more than 5 then the
-					packing-cutoff is almost certainly too
-					high; the values are the residue-keys
-					of the contacting residues */
+	contact[MAX_RESIDUES][MAX_CONTACTS];	/* the n_contacts contacts
+					are stored here; up to MAX_CONTACTS
+					can be stored, but if there are more
+					than 5 then the packing-cutoff is
+					almost certainly too high; the values
+					are the residue-keys of the contacting
+					residues */
 
 char	helix_residue_name[MAX_RESIDUES][5],	/* residue name (PDB 'resName'
 						field; this is not entirely
@@ -346,16 +452,17 @@ char	helix_residue_name[MAX_RESIDUES][5],	/* residue name (PDB 'resName'
 					which is useful for when outputting
 					residue	details for the user */
 
-	tad_register[MAX_RESIDUES][MAX_COILED_COILS],	/* the heptad register
-							(0..6, corresponding to
-						a..g) of the residue, if any; in
-						complex assemblies, a residue
-						can contribute to more than one
-						coiled coil, so its a 2D array,
-						indexed by the coiled-coil-key*/
-
 	helix_residue_iCode[MAX_RESIDUES]; /* XXX one for the future... sort this out */
 
+int	helix_residue_start[MAX_HELICES+1],	/* helix_residue[] elements
+						helix_residue_start[h] ..
+						helix_residue_start[h+1]-1 are
+						the residues of helix h */
+
+	helix_residue[MAX_RESIDUES];	/* residue-keys, in order of helix-key
+					and then of residue-key; see
+					index_helix_residues() */
+
 /* N.B. there is no GLOBAL record of the total number of helical residues which
 have been read in; the variable residue_index is local to main(), which is
 sloppy - see notes on atom_index above */
@@ -374,6 +481,15 @@ int	helix_start[MAX_HELICES],	/* the residue sequence number (PDB
 					residue of the helix; *NOT* the
 					residue-key of that residue */
 
+	helix_N_residue[MAX_HELICES],	/* the residue-key of the most
+					N-terminal residue of the helix (i.e.
+					that of helix_start); -1 if it was not
+					read in; set by determine_helix_axes() */
+
+	helix_C_residue[MAX_HELICES],	/* the residue-key of the most
+					C-terminal residue of the helix (i.e.
+					that of helix_end), likewise */
+
 	n_knobs[MAX_HELICES],		/* the number of residues in the helix
 					which are knobs of any type */
 
@@ -409,6 +525,15 @@ char	helix_chain[MAX_HELICES],	/* the chain identifier (PDB 'chainID'
 					field) of the most C-terminal residue of the
 					helix */
 
+float	helix_axis[MAX_HELICES][3];	/* a unit vector along the axis of
+					the helix, pointing from its N- to its
+					C-terminus; by default this is the
+					direction from the reference atom (0) of
+					helix_N_residue to that of
+					helix_C_residue, or, if -x is set, the
+					least-squares line through the helix
+					(see determine_helix_axes()) */
+
 
 
 /* scalars describing helices ............................................... */
@@ -429,29 +554,34 @@ int seqchain[MAX_SEQCHAINS];		/* the (PDB) serial number of the first
 
 /* arrays describing knobs .................................................. */
 	/* these are indexed by the knob-key, which starts at zero;
-	usually integer variable k is used as the index */
-
-int	knob[MAX_KNOBS], 		/* the residue-key of the residue
+	usually integer variable k is used as the index; the fields used in
+	the searches for complementary knobs, daisy chains and registers
+	are held together in one record per knob, and its geometry in
+	another (knob_geometry[]), which is measured once, as soon as the
+	hole is known (see measure_knob()), and only read thereafter */
+
+struct knob {
+	int	residue,		/* the residue-key of the residue
 					whose side chain is the knob */
 
-	knobtype[MAX_KNOBS],		/* the type of the knob : a null
+		type,			/* the type of the knob : a null
 					value 0, or 1,2,3,4, or in rare
 					cases 5 or 6 ('double knobs') */
 
-	hole[MAX_KNOBS][4], 		/* the residue-keys of the 4 residues
+		hole[4], 		/* the residue-keys of the 4 residues
 					which form the hole into which the
 					knob fits; there are always 4 hole
 					residues (if a residue has more than
 					4 contacts - see above - then the best
 					4 are selected to make the hole) */
 
-	n_compknob[MAX_KNOBS],		/* the number of complementary knobs*/
+		n_compknob,		/* the number of complementary knobs*/
 
-	compknob[MAX_KNOBS][MAX_COMPKNOBS],	/* the knob-key of all the
+		compknob[MAX_COMPKNOBS],	/* the knob-key of all the
 						knobs complementary to this
 						knob */
 
-	knob_order[MAX_KNOBS];		/* the number of knobs in the
+		order;			/* the number of knobs in the
 					complementary arrangement to which the
 					knob belongs; i.e. 2 for pairwise
 					complementary, 3,4 or 5 for 3-, 4-,
@@ -459,7 +589,7 @@ int	knob[MAX_KNOBS], 		/* the residue-key of the residue
 					assemblies, a knob can be part of more
 					than one cyclic arrangement (i.e. more
 					than one coiled coil); in this event
-					the knob_order is the highest order of
+					the order is the highest order of
 					any of the coiled coils (this frequently
 					happens in 4- and 5-stranded, and less
 					often in 3-stranded, where a core knob
@@ -467,21 +597,34 @@ int	knob[MAX_KNOBS], 		/* the residue-key of the residue
 					core knobs (order > 2), but pairwise-
 					complementary with a peripheral knob
 					(order = 2) ) */
+	} knob[MAX_KNOBS];
+
+struct knob_geometry {
+	float	hole_distance[4],	/* the distance between the centre of
+					volume of the knob sidechain and the
+					hole sidechain (0..3) JW 13-7-6 */
 
-float  angle[MAX_KNOBS],		/* the core-packing angle of the knob,
+		side[4],		/* the lengths of the four sides of
+					the hole: the distances between the
+					centres of volume of hole residues 0-1,
+					0-2, 1-3 and 2-3 */
+
+		end_distance,		/* the mean distance between the end of
+					the knob side chain and the alpha-
+					carbons of the hole residues; see
+					function measure_k_end_h_CA() */
+
+		angle;			/* the core-packing angle of the knob,
 					in degrees; see function packing_angle()
 					*/
+	} knob_geometry[MAX_KNOBS];
 
-      contact_distance[MAX_RESIDUES][10], /* added by JW 13-7-6.
+float contact_distance[MAX_RESIDUES][MAX_CONTACTS]; /* added by JW 13-7-6.
 	                                This records the distances between
 					residues (centres-of-volume) which are
 				        'in contact', i.e. CoVs separated by
 					the cutoff distance or less */
 
-       hole_distance[MAX_KNOBS][4];    /* the distance between the centre of
-	                                volume of the knob sidechain and the
-					hole sidechain (0..3) JW 13-7-6 */
-
 
 /* scalars describing knobs ................................................. */
 int	knob_index;			/* the total number of knobs (of any
@@ -490,18 +633,74 @@ int	knob_index;			/* the total number of knobs (of any
 					another helix */
 
 
+/* arrays indexing knobs by residue and helix, and linking knobs into holes . */
+	/* both are in compressed sparse row form: a list of knob-keys,
+	and an array of offsets into it; see index_knobs() and
+	build_knob_graph() */
+
+int	residue_knob_start[MAX_RESIDUES+1],	/* residue_knob[] elements
+						residue_knob_start[r] ..
+					residue_knob_start[r+1]-1 are the
+					knobs whose residue-key is r (usually
+					none or one; more than one only for
+					duplicate knobs); indexed by
+					residue-key */
+
+	residue_knob[MAX_KNOBS],	/* knob-keys, in order of residue-key,
+					and then of knob-key */
+
+	helix_knob_start[MAX_HELICES+1],	/* likewise, helix_knob[]
+						elements helix_knob_start[h] ..
+					helix_knob_start[h+1]-1 are the knobs
+					on helix h; indexed by helix-key */
+
+	helix_knob[MAX_KNOBS],		/* knob-keys, in order of helix-key,
+					and then as in residue_knob[] */
+
+	residue_register_start[MAX_RESIDUES+1],	/* likewise,
+						residue_register_cc[] elements
+					residue_register_start[r] ..
+					residue_register_start[r+1]-1 are the
+					coiled coils in which residue r has a
+					heptad register (a..g); in complex
+					assemblies, a residue can contribute to
+					more than one coiled coil; the register
+					itself is get_register(r,c) (see
+					register.c) */
+
+	residue_register_cc[MAX_REGISTERS],	/* coiled-coil-keys, in order
+						of residue-key, and then of
+					coiled-coil-key; see index_registers() */
+
+	knob_link_start[MAX_KNOBS+1],	/* knob_link[] elements
+					knob_link_start[k] ..
+					knob_link_start[k+1]-1 are the knobs
+					linked from knob k; indexed by
+					knob-key */
+
+	knob_link[MAX_KNOB_LINKS];	/* the knob-into-hole graph: knob k is
+					linked to each knob which is one of the
+					two sides (hole[k][1], hole[k][2]) of
+					the hole into which k fits, and whose
+					own hole is not in k's helix (which
+					would make the two pairwise
+					complementary); the daisy chains are
+					the cycles of this graph */
+
+
 /* arrays describing sets of duplicate knobs ................................ */
-int	duplicate_knobs[MAX_DUPLICATES][3];	/* it is possible for a side
+int	duplicate_residue[MAX_KNOBS/2];	/* it is possible for a side
 						chain to fit into more than one
-					hole (see MAX_DUPLICATES); it is
-					inconceivable that a side chain could
-					fit into more than 2 holes, unless the
-					packing-cutoff were stupidly high, but
-					the 2nd dimension has 3 elements anyway;
-					two different knob-keys could in fact
-					describe one and the same residue, and
-					such relationships are store here; each
-					value of duplicate_knobs is a knob-key*/
+					hole, particularly if the packing-
+					cutoff is on the high side; two or more
+					different knob-keys then describe one
+					and the same residue; each set of such
+					knobs is stored here as that residue
+					(a residue-key), in order of the lowest
+					knob-key in the set; the knobs
+					themselves are those listed for the
+					residue by residue_knob_start[] and
+					residue_knob[] (see index_knobs()) */
 
 /* scalars describing sets of duplicate knobs ............................... */
 int	n_duplicate_knobs;		/* the number of sets of 'different'
@@ -642,6 +841,20 @@ float   coiled_coil_mean_length[MAX_COILED_COILS];	/* the mean of all the
 						see coiled_coil_max_length
 						(above) */
 
+signed char	helix_pair_orientation[MAX_HELICES][MAX_HELICES];	/* the
+							relative orientation (0
+						= parallel, 1 = antiparallel) of
+						each pair of helices (indexed by
+						helix serial number) which
+						interact by knobs-into-holes, as
+						assessed by find_register(); -1
+						if not (yet) determined; it is
+						looked up with the lower helix
+						serial number first, and so the
+						relative orientation of two
+						helices is the same whichever
+						coiled coil they are in */
+
 /* scalars describing coiled coils .......................................... */
 
 int	n_total_ccs,		/* the total number of 'coiled coils' in the
@@ -674,10 +887,13 @@ int	knob_threshold,		/* the lowest knob-type defined as
 				and a constant used instead of this variable
 				with -k disabled */
 
-	extend;			/* the helix-extension in residues; the value
+	extend,			/* the helix-extension in residues; the value
 				used is either defined by -e or else 0 is used;
 				values of 0, 1 or 2 are acceptable */
 
+	threads;		/* the number of threads used by
+				find_register(); defined by -j, or else 1 */
+
 float	/*cutoff0,*/		/* refer to 'GLOBAL VARIABLES: side
 				chain-position descriptors; each side chain is
 				defined by the position of its proximal end
@@ -697,6 +913,22 @@ float	/*cutoff0,*/		/* refer to 'GLOBAL VARIABLES: side
 char cutoff_warning;		/* this is set to a space character; its name
 				is for historical reasons */
 
+enum boolean tracing;		/* set while the trace file (--trace) is
+				open; see trace.c */
+
+double	trace_min;		/* the shortest helix pair search (in
+				microseconds) written to the trace; defined by
+				--trace-min, or else 1000 */
+
+int	contacts_high_water;	/* the most contacts any residue has had
+				at once (contacts are reset for each helix
+				pair); reported by --mem-report */
+
+long	work_count[COUNTS];	/* the counts of work done (helix pairs
+				tested, residue pairs measured, contacts added,
+				knobs, steps of the daisy chain search, true
+				coiled coils), reported by -T */
+
 
 /* Multi purpose string variables used in several functions.................. */
 
@@ -742,10 +974,20 @@ FILE	*pdb_file,		/* used by read_helical_pdb function, to read
 				the positions of helices in the sequence is
 				read by these functions */
 
+/* the text of the PDB and DSSP files, and their sizes, when they are sent inline
+in a request to the daemon (--serve); check_files() then reads them from
+memory, rather than opening -f and -s (see serve.c) */
+
+char	*served_pdb,
+	*served_dssp;
+size_t	served_pdb_size,
+	served_dssp_size;
+
 /* output-files ............................................................. */
 
 FILE	*data_outfile,		/* redundant; specified by -d */
 	*long_outfile,		/* 'long', one-residue-per line outfile (-o) */
 	*rasmol_file,		/* RasMol script file (-r) */
+	*json_file,		/* JSON results file (-J) */
 	*helix_register_file;	/* redundant; specified by -w */
 
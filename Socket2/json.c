@@ -0,0 +1,255 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					json.c
+
+
+Description: this C program identifies coiled-coil motifs in a Protein Data Bank
+(Berman et al, Nucleic Acids Res v28 pp235-42, 2000) file. Also required as
+input is a DSSP (Kabsch & Sander, Biopolymers v22 pp 2577-637) file derived from
+the PDB file.
+
+
+*/
+
+/*					json.c
+					------
+
+The results, written as a single JSON document (-J), so that they can be read
+by a program without scraping the standard output, the 'long' file (-o) or the
+RasMol script (-r). It is written from the in-memory results once
+find_register() has been, and holds:
+
+	"helices"	one object per helix (helix-key order): chain, the PDB
+			numbers of its first and last residues, and the residue-
+			keys of its first and last residues
+
+	"residues"	one object per helical residue (residue-key order): its
+			helix, chain, PDB number, insertion code and name, and its
+			heptad register in each true coiled coil it belongs to
+
+	"knobs"		one object per knob (knob-key order): its residue, type
+			and order, the 4 residues of its hole and their distances
+			(hole_distances[i] being that of hole[i]), the hole's
+			side lengths, the packing angle and the knob-keys of its
+			complementary knobs
+
+	"daisy_chains"	the knob-keys of each cyclic layer, and its coiled coil
+
+	"coiled_coils"	the true coiled coils only (see find_register()): their
+			number (as in the roman numerals of the standard output),
+			orientation, order (number of helices), lengths, and for
+			each helix the residue-keys of the ends of its knobs-into-
+			holes region
+
+Residues, knobs, helices and coiled coils are referred to by their keys ("id"),
+which start at zero. A measurement which cannot be made (e.g. a packing angle
+without C-beta atoms) is written as null.
+*/
+
+#include "socket.h"
+
+
+/* writes s as a JSON string */
+
+static void json_string(FILE *out, char s[])
+	{
+	fputc('"',out);
+	for (; *s; s++)
+		{
+		if ((*s == '"') || (*s == '\\')) fprintf(out,"\\%c",*s);
+		else if ((unsigned char) *s < ' ') fprintf(out,"\\u%04x",(unsigned char) *s);
+		else fputc(*s,out);
+		}
+	fputc('"',out);
+	}
+
+/* writes the single character c (a chain identifier, insertion code or
+register) as a JSON string */
+
+static void json_char(FILE *out, char c)
+	{
+	char s[2];
+
+	s[0] = c;
+	s[1] = '\0';
+	json_string(out,s);
+	}
+
+/* writes x, or null if it is not a number (or is the 99999.9 'no distance'
+value of measure_centre_distance()) */
+
+static void json_float(FILE *out, float x)
+	{
+	if (isnan(x) || isinf(x) || (x > 99999.0)) fprintf(out,"null");
+	else fprintf(out,"%.3f",x);
+	}
+
+/* writes a list of n integers */
+
+static void json_ints(FILE *out, int list[], int n)
+	{
+	int i;
+
+	fputc('[',out);
+	for (i = 0; i < n; i++) fprintf(out,"%s%d",i ? "," : "",list[i]);
+	fputc(']',out);
+	}
+
+/* writes a list of n floats */
+
+static void json_floats(FILE *out, float list[], int n)
+	{
+	int i;
+
+	fputc('[',out);
+	for (i = 0; i < n; i++)
+		{
+		if (i) fputc(',',out);
+		json_float(out,list[i]);
+		}
+	fputc(']',out);
+	}
+
+
+static void json_helices(FILE *out)
+	{
+	int h;
+
+	fprintf(out,"\"helices\":[");
+	for (h = 0; h < helix_index; h++)
+		{
+		fprintf(out,"%s\n{\"id\":%d,\"chain\":",h ? "," : "",h);
+		json_char(out,helix_chain[h]);
+		fprintf(out,",\"start\":%d,\"end\":%d,\"first_residue\":",helix_start[h],helix_end[h]);
+		if (helix_residue_start[h] < helix_residue_start[h+1])
+			fprintf(out,"%d,\"last_residue\":%d}",helix_residue[helix_residue_start[h]],
+				helix_residue[helix_residue_start[h+1]-1]);
+		else	fprintf(out,"null,\"last_residue\":null}");
+		}
+	fprintf(out,"]");
+	}
+
+
+static void json_residues(FILE *out, int residue_index)
+	{
+	int c,i,n,r;
+
+	fprintf(out,"\"residues\":[");
+	for (r = 0; r < residue_index; r++)
+		{
+		fprintf(out,"%s\n{\"id\":%d,\"helix\":%d,\"chain\":",r ? "," : "",r,helix_no[r]);
+		json_char(out,helix_chain[helix_no[r]]);
+		fprintf(out,",\"number\":%d,\"iCode\":",helix_residue_no[r]);
+		json_char(out,helix_residue_iCode[r]);
+		fprintf(out,",\"name\":");
+		json_string(out,helix_residue_name[r]);
+
+		/* the registers of the residue in the true coiled coils, as in the
+		'long' file (see write_files()) */
+		fprintf(out,",\"registers\":[");
+		n = 0;
+		for (i = residue_register_start[r]; i < residue_register_start[r+1]; i++)
+			{
+			c = residue_register_cc[i];
+			if (coiled_coil_subset[c] != -1) continue;
+			fprintf(out,"%s{\"coiled_coil\":%d,\"register\":",n++ ? "," : "",c);
+			json_char(out,get_register(r,c));
+			fputc('}',out);
+			}
+		fprintf(out,"]}");
+		}
+	fprintf(out,"]");
+	}
+
+
+static void json_knobs(FILE *out)
+	{
+	int k;
+
+	fprintf(out,"\"knobs\":[");
+	for (k = 0; k < knob_index; k++)
+		{
+		fprintf(out,"%s\n{\"id\":%d,\"residue\":%d,\"helix\":%d,\"type\":%d,\"order\":%d,",
+			k ? "," : "",k,knob[k].residue,helix_no[knob[k].residue],knob[k].type,knob[k].order);
+		fprintf(out,"\"hole\":");
+		json_ints(out,knob[k].hole,4);
+		fprintf(out,",\"hole_helix\":%d,\"hole_distances\":",helix_no[knob[k].hole[0]]);
+		json_floats(out,knob_geometry[k].hole_distance,4);
+		fprintf(out,",\"hole_sides\":");
+		json_floats(out,knob_geometry[k].side,4);
+		fprintf(out,",\"end_distance\":");
+		json_float(out,knob_geometry[k].end_distance);
+		fprintf(out,",\"angle\":");
+		json_float(out,knob_geometry[k].angle);
+		fprintf(out,",\"partners\":");
+		json_ints(out,knob[k].compknob,knob[k].n_compknob);
+		fputc('}',out);
+		}
+	fprintf(out,"]");
+	}
+
+
+static void json_daisy_chains(FILE *out)
+	{
+	int d,n;
+
+	fprintf(out,"\"daisy_chains\":[");
+	for (d = 0; d < daisy_chains; d++)
+		{
+		for (n = 0; (n < MAX_DAISIES) && (daisy_chain[d][n] != -1); n++);
+		fprintf(out,"%s\n{\"id\":%d,\"coiled_coil\":%d,\"knobs\":",d ? "," : "",d,daisy_chain_cc[d]);
+		json_ints(out,daisy_chain[d],n);
+		fputc('}',out);
+		}
+	fprintf(out,"]");
+	}
+
+
+static void json_coiled_coils(FILE *out)
+	{
+	int c,helix,true_ccs;
+
+	fprintf(out,"\"coiled_coils\":[");
+	true_ccs = 0;
+	for (c = 0; c < coiled_coils; c++)
+		if ((coiled_coil_subset[c] == -1) && ((coiled_coil_helices[c] > 2) || (coiled_coil_tally[c] > 1)))
+			{
+			fprintf(out,"%s\n{\"id\":%d,\"number\":%d,\"orientation\":\"%s\",\"order\":%d,",
+				true_ccs ? "," : "",c,true_ccs + 1,
+				coiled_coil_orientation[c] ? "antiparallel" : "parallel",coiled_coil_helices[c]);
+			fprintf(out,"\"max_length\":%d,\"mean_length\":",coiled_coil_max_length[c]);
+			json_float(out,coiled_coil_mean_length[c]);
+			fprintf(out,",\"helices\":[");
+			for (helix = 0; helix < coiled_coil_helices[c]; helix++)
+				fprintf(out,"%s{\"helix\":%d,\"begin\":%d,\"end\":%d}",helix ? "," : "",
+					coiled_coil[c][helix],coiled_coil_begin[c][helix][1],
+					coiled_coil_end[c][helix][1]);
+			fprintf(out,"]}");
+			true_ccs++;
+			}
+	fprintf(out,"]");
+	}
+
+
+void write_json(int residue_index)
+	{
+	fprintf(json_file,"{\"program\":\"SOCKET\",\"code\":");
+	json_string(json_file,code);
+	fprintf(json_file,",\"cutoff\":%.2f,\"extend\":%d,\n",cutoff2,extend);
+
+	json_helices(json_file);
+	fprintf(json_file,",\n");
+	json_residues(json_file,residue_index);
+	fprintf(json_file,",\n");
+	json_knobs(json_file);
+	fprintf(json_file,",\n");
+	json_daisy_chains(json_file);
+	fprintf(json_file,",\n");
+	json_coiled_coils(json_file);
+	fprintf(json_file,"\n}\n");
+
+	fclose(json_file);
+	}
@@ -0,0 +1,199 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					knobcols.c
+
+
+Description: this C program identifies coiled-coil motifs in a Protein Data Bank
+(Berman et al, Nucleic Acids Res v28 pp235-42, 2000) file. Also required as
+input is a DSSP (Kabsch & Sander, Biopolymers v22 pp 2577-637) file derived from
+the PDB file.
+
+
+*/
+
+/*					knobcols.c
+					----------
+
+The knobs, written as a table in columns (-K <directory>), for statistics over
+many structures: each run appends one row per knob to every column, so a batch
+run over a whole set of PDB files builds up one table, and an analysis reads
+only the columns it needs (e.g. name.col and angle.col for the packing angle by
+residue type).
+
+Each column is a file of fixed-width fields, one per row, with no header, so
+row i of a column of width w starts at byte i * w, and the number of rows is
+the size of any column divided by its width. Integers and floats are written
+little-endian whatever the machine; floats are IEEE 754 single precision;
+character fields are padded with NULs. The columns are:
+
+	file		width	field
+	entry.col	16	the code of the PDB file (see get_code()); a
+				longer code is an error, not truncated
+	chain.col	1	the chain of the knob
+	residue.col	4	the PDB residue number of the knob (int32)
+	icode.col	1	its insertion code
+	name.col	3	its residue name
+	type.col	1	the knobtype (int8; see struct knob)
+	order.col	1	the knob order (int8; -1 if it has no
+				complementary knob)
+	angle.col	4	the packing angle (float32, degrees; NaN if it
+				cannot be measured)
+	hole_chain.col	1	the chain of the hole
+	hole_residue.col 16	the PDB residue numbers of the 4 hole residues
+				(4 x int32)
+	hole_distance.col 16	the distances of the 4 hole residues from the
+				knob (4 x float32)
+
+The same layout is described in the file SCHEMA, written into the directory
+when it is first used. All the columns of a run are written together, so the
+table is only inconsistent if a run is stopped part way through writing it.
+*/
+
+#include "socket.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+
+enum knob_column {col_entry,col_chain,col_residue,col_icode,col_name,col_type,
+	col_order,col_angle,col_hole_chain,col_hole_residue,col_hole_distance,
+	KNOB_COLUMNS};
+
+static char *column_name[KNOB_COLUMNS] = {"entry","chain","residue","icode",
+	"name","type","order","angle","hole_chain","hole_residue","hole_distance"};
+
+static int column_width[KNOB_COLUMNS] = {16,1,4,1,3,1,1,4,1,16,16};
+
+static char *column_description[KNOB_COLUMNS] = {
+	"char[16] code of the PDB file",
+	"char knob chain",
+	"int32 knob PDB residue number",
+	"char knob insertion code",
+	"char[3] knob residue name",
+	"int8 knobtype",
+	"int8 knob order (-1 if none)",
+	"float32 packing angle (degrees; NaN if not measured)",
+	"char hole chain",
+	"int32[4] hole PDB residue numbers",
+	"float32[4] hole residue distances from the knob (Angstroms)"};
+
+
+/* the field of n characters from s, padded with NULs */
+
+static void put_chars(FILE *out, char s[], int n)
+	{
+	int i;
+
+	for (i = 0; (i < n) && s[i]; i++) fputc(s[i],out);
+	for (; i < n; i++) fputc('\0',out);
+	}
+
+static void put_int32(FILE *out, int x)
+	{
+	unsigned int u = (unsigned int) x;
+
+	fputc(u & 0xff,out);
+	fputc((u >> 8) & 0xff,out);
+	fputc((u >> 16) & 0xff,out);
+	fputc((u >> 24) & 0xff,out);
+	}
+
+static void put_float32(FILE *out, float x)
+	{
+	union { float f; unsigned int u; } v;
+
+	v.f = x;
+	put_int32(out,(int) v.u);
+	}
+
+
+/* creates directory dir, and its SCHEMA, if it is not there already */
+
+static void knob_column_directory(char dir[])
+	{
+	char file_name[MAX_FILE_NAME_LENGTH + 20];
+	FILE *schema;
+	int i;
+
+	if (mkdir(dir,0777) && (errno != EEXIST))
+		{
+		printf("Failed to create knob column directory \"%s\"\n\n",dir);
+		exit(1);
+		}
+
+	sprintf(file_name,"%s/SCHEMA",dir);
+	if ((schema = fopen(file_name,"r")) != NULL)
+		{
+		fclose(schema);
+		return;
+		}
+	if ((schema = fopen(file_name,"w")) == NULL)
+		{
+		printf("Failed to open knob column schema \"%s\"\n\n",file_name);
+		exit(1);
+		}
+	fprintf(schema,"# SOCKET knob columns: one row per knob; fixed-width fields,\n"
+		"# little-endian, no header; rows = file size / width\n# file\twidth\tfield\n");
+	for (i = 0; i < KNOB_COLUMNS; i++)
+		fprintf(schema,"%s.col\t%d\t%s\n",column_name[i],column_width[i],column_description[i]);
+	fclose(schema);
+	}
+
+
+void write_knob_columns(char dir[])
+	{
+	FILE *column[KNOB_COLUMNS];
+	char file_name[MAX_FILE_NAME_LENGTH + 20];
+	int i,k,r;
+
+	if (strlen(dir) > MAX_FILE_NAME_LENGTH)
+		{
+		printf("knob column directory name \"%s\" is too long\n\n",dir);
+		exit(1);
+		}
+	/* checked before any column is written, so that the rows stay whole */
+	if ((int) strlen(code) > column_width[col_entry])
+		{
+		printf("the code \"%s\" of the PDB file is longer than the %d characters of entry.col\n\n",
+			code,column_width[col_entry]);
+		exit(1);
+		}
+
+	knob_column_directory(dir);
+
+	for (i = 0; i < KNOB_COLUMNS; i++)
+		{
+		sprintf(file_name,"%s/%s.col",dir,column_name[i]);
+		if ((column[i] = fopen(file_name,"ab")) == NULL)
+			{
+			printf("Failed to open knob column \"%s\"\n\n",file_name);
+			exit(1);
+			}
+		}
+
+	for (k = 0; k < knob_index; k++)
+		{
+		r = knob[k].residue;
+		put_chars(column[col_entry],code,column_width[col_entry]);
+		fputc(helix_chain[helix_no[r]],column[col_chain]);
+		put_int32(column[col_residue],helix_residue_no[r]);
+		fputc(helix_residue_iCode[r],column[col_icode]);
+		put_chars(column[col_name],helix_residue_name[r],3);
+		fputc((signed char) knob[k].type,column[col_type]);
+		fputc((signed char) knob[k].order,column[col_order]);
+		put_float32(column[col_angle],knob_geometry[k].angle);
+		fputc(helix_chain[helix_no[knob[k].hole[0]]],column[col_hole_chain]);
+		for (i = 0; i < 4; i++)
+			{
+			put_int32(column[col_hole_residue],helix_residue_no[knob[k].hole[i]]);
+			put_float32(column[col_hole_distance],knob_geometry[k].hole_distance[i]);
+			}
+		}
+
+	for (i = 0; i < KNOB_COLUMNS; i++) fclose(column[i]);
+
+	if (!setflag[flag_p]) printf("appended %d knobs to \"%s\"\n",knob_index,dir);
+	}
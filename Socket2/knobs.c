@@ -33,10 +33,32 @@ the PDB file.
 
 #include "socket.h"
 
+/* the residue-keys of the two helices of the pair currently being assessed,
+in ascending order; only these residues can have contacts */
+
+static int	pair_residue[MAX_RESIDUES],
+		pair_residues;
+
+void list_pair_residues(int helix1, int helix2)
+	{
+	int a,b;
+
+	pair_residues = 0;
+	a = helix_residue_start[helix1];
+	b = helix_residue_start[helix2];
+	while ((a < helix_residue_start[helix1+1]) || (b < helix_residue_start[helix2+1]))
+		if ((b == helix_residue_start[helix2+1]) ||
+			((a < helix_residue_start[helix1+1]) && (helix_residue[a] < helix_residue[b])))
+			pair_residue[pair_residues++] = helix_residue[a++];
+		else	pair_residue[pair_residues++] = helix_residue[b++];
+	}
+
 void find_knobs_and_holes(int residue_index)
 	{
 	int i,j,k,sub_index;
 	enum boolean is_first;
+	double pair_start = 0.0;
+	long pair_residue_pairs = 0;
 /* this array of colours written to the rasmol script, if specified,
 used to be local to find_knobs_and_holes(), but is now required
 by another short routine (in main()) */
@@ -53,10 +75,32 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 			if (i != j)
 				{
 				if (setflag[flag_v] || setflag[flag_l]) printf("\nhelices %3d,%3d:\n",i,j);
-				reset_contacts();
-				measure_helix_pair(i,j,residue_index);
-				best_kih(residue_index);
-				report_kih(residue_index);
+				work_count[count_helix_pairs]++;
+				if (tracing)
+					{
+					pair_start = monotonic_seconds();
+					pair_residue_pairs = work_count[count_residue_pairs];
+					}
+
+				/* the contact search (of the residue pairs of the two
+				helices) is a stage apart from the rest of the knobs stage,
+				the classification of the knobs it finds */
+				stage_begin(stage_contacts);
+				list_pair_residues(i,j);
+				if (setflag[flag_legacy]) legacy_contacts(i,j,residue_index);
+				else
+					{
+					reset_contacts();
+					measure_helix_pair(i,j);
+					}
+				stage_end(stage_contacts);
+
+				if (setflag[flag_legacy]) legacy_best_kih(residue_index);
+				else best_kih();
+				report_kih();
+				if (tracing)
+					trace_helix_pair(i,j,pair_start,
+						work_count[count_residue_pairs] - pair_residue_pairs);
 				}
 	if (setflag[flag_debug])
 		{
@@ -64,9 +108,15 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 		printf("all helices checked; DUMPING KNOBS\n");
 		}
 
-	check_complementarity();
+	work_count[count_knobs] = knob_index;
+
+	stage_begin(stage_complementarity);
+	check_complementarity(residue_index);
+	stage_end(stage_complementarity);
 
+	stage_begin(stage_duplication);
 	check_duplication();
+	stage_end(stage_duplication);
 
 	/* tally number of knobs (and holes) of each type; total is cumulative*/
 
@@ -76,10 +126,10 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 
 	for (k = 0; k < knob_index; k++)
 		{
-		for (j = 0; j <= knobtype[k]; j++)
+		for (j = 0; j <= knob[k].type; j++)
 			{
-			n_knobtype[helix_no[knob[k]]][j]++;
-			n_holetype[helix_no[hole[k][0]]][j]++;
+			n_knobtype[helix_no[knob[k].residue]][j]++;
+			n_holetype[helix_no[knob[k].hole[0]]][j]++;
 			}
 		}
 
@@ -110,13 +160,13 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 			}
 
 		for (i = 0; i < knob_index; i++)
-			if ((helix_no[knob[i]] == j) && (knobtype[i] >= knob_threshold) )
+			if ((helix_no[knob[i].residue] == j) && (knob[i].type >= knob_threshold) )
 				{
 
 				if (!setflag[flag_q]) printf("%d) %d (%s %d:%c, iCode='%c', helix %d) type %d\t",
-					i,knob[i],helix_residue_name[knob[i]],helix_residue_no[knob[i]],
-					helix_chain[helix_no[knob[i]]], helix_residue_iCode[knob[i]],
-					helix_no[knob[i]],knobtype[i]);
+					i,knob[i].residue,helix_residue_name[knob[i].residue],helix_residue_no[knob[i].residue],
+					helix_chain[helix_no[knob[i].residue]], helix_residue_iCode[knob[i].residue],
+					helix_no[knob[i].residue],knob[i].type);
 
 				if (par[par_r] && n_knobs[j]) {
 
@@ -146,7 +196,7 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 					/* N.B. when writing the RasMol script file, insertion codes (iCode)
 					are assumed to be null; not sure if RasMol deals with them correctly */
 
-					fprintf(rasmol_file,"%d:%c",helix_residue_no[knob[i]],helix_chain[helix_no[knob[i]]]);
+					fprintf(rasmol_file,"%d:%c",helix_residue_no[knob[i].residue],helix_chain[helix_no[knob[i].residue]]);
 
 					is_first = false;
 
@@ -158,11 +208,11 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 					{
 					if ((k) && (!setflag[flag_q])) printf(",");
 					if (!setflag[flag_q]) 
-						printf(" %s %d:%c iCode='%c'",helix_residue_name[hole[i][k]],helix_residue_no[hole[i][k]],
-					helix_chain[helix_no[hole[i][k]]],helix_residue_iCode[hole[i][k]]);
+						printf(" %s %d:%c iCode='%c'",helix_residue_name[knob[i].hole[k]],helix_residue_no[knob[i].hole[k]],
+					helix_chain[helix_no[knob[i].hole[k]]],helix_residue_iCode[knob[i].hole[k]]);
 					}
 
-				if (!setflag[flag_q]) printf(" helix %d) packing angle %8.3f\n",helix_no[hole[i][0]],angle[i]);
+				if (!setflag[flag_q]) printf(" helix %d) packing angle %8.3f\n",helix_no[knob[i].hole[0]],knob_geometry[i].angle);
 				}
 
 		--sub_index;
@@ -201,14 +251,14 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 			}
 
 		for (i = 0; i < knob_index; i++)
-			if ((helix_no[hole[i][0]] == j) && (knobtype[i] >= knob_threshold))
+			if ((helix_no[knob[i].hole[0]] == j) && (knob[i].type >= knob_threshold))
 				{
 				for (k = 0; k < 4; k++)
 					{
 					if ((k) && (!setflag[flag_q])) printf(",");
 					if (!setflag[flag_q]) 
-						printf(" %s %d:%c iCode='%c'",helix_residue_name[hole[i][k]],helix_residue_no[hole[i][k]],
-					helix_chain[helix_no[hole[i][k]]], helix_residue_iCode[hole[i][k]]);
+						printf(" %s %d:%c iCode='%c'",helix_residue_name[knob[i].hole[k]],helix_residue_no[knob[i].hole[k]],
+					helix_chain[helix_no[knob[i].hole[k]]], helix_residue_iCode[knob[i].hole[k]]);
 					if (par[par_r] && n_hole_res[j]) {
 
 						/* check that the rasmol line defining this set is not too long-
@@ -231,13 +281,13 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 						sub_index++;
 
 						if (!is_first) fprintf(rasmol_file,",");
-						fprintf(rasmol_file,"%d:%c",helix_residue_no[hole[i][k]],helix_chain[helix_no[hole[i][k]]]);
+						fprintf(rasmol_file,"%d:%c",helix_residue_no[knob[i].hole[k]],helix_chain[helix_no[knob[i].hole[k]]]);
 						is_first = false;
 						}
 					}
 				if (!setflag[flag_q]) 
-					printf(" (knob: %d (%s %d:%c, helix %d))\n",knob[i],helix_residue_name[knob[i]],helix_residue_no[knob[i]],
-				helix_chain[helix_no[knob[i]]],helix_no[knob[i]]);
+					printf(" (knob: %d (%s %d:%c, helix %d))\n",knob[i].residue,helix_residue_name[knob[i].residue],helix_residue_no[knob[i].residue],
+				helix_chain[helix_no[knob[i].residue]],helix_no[knob[i].residue]);
 				}
 		if (par[par_r] && n_holetype[j][knob_threshold])
 			{
@@ -315,105 +365,128 @@ char *rasmol_colour[RASMOL_COLOURS] = {"red","green","blue","magenta",
 
 
 void reset_contacts()
-	{ int i; for (i = 0; i < MAX_RESIDUES; i++) n_contacts[i] = 0;}
+	{ int i; for (i = 0; i < pair_residues; i++) n_contacts[pair_residue[i]] = 0;}
 
-void best_kih(int residue_index)
+void best_kih()
 /* If there are > 4 residues in contact with a side chain, then find the
 	best (most 'hole-like') group of four;
 	the first group of 4 putative hole residues with a 3,1,3 spacing
 	(ie X--XX--X) will be used as the hole; if no such group exists then
 	any group where the second and third residues are consecutive will
-	be used.
-	In either case, the contact[j][] array will be rearranged so that
-	the 4 residues constituting the best group will occupy the first
-	4 elements. This is because later functions which test the hole
+	be used (of these, the last in the order in which the groups used to
+	be enumerated, i.e. the last such pair, the residue before it and the
+	last contact).
+	The contacts are sorted by residue-key first (they are normally found
+	in that order anyway, see measure_helix_pair()), so that both spacings
+	are found by a single scan along the contacts, rather than by trying
+	every group of 4.
+	In either case, the contact[j][] array (and contact_distance[j][]
+	with it) will be rearranged so that the 4 residues constituting the
+	best group will occupy the first 4 elements. This is because later functions which test the hole
 	spacing pattern assume that there is an x,1,y spacing pattern (anything
 	but the first 4 elements are ignored);
 	groups which do not match this will be discarded*/
 	{
-	int pos[4], best[4], i,j, ok;
+	int best[4], i,j,k,n,r,x,p1,p3;
+	float d;
 
-	for (j = 0; j < residue_index; j++)
+	for (r = 0; r < pair_residues; r++)
 		{
-		if (n_contacts[j] > 4)
+		j = pair_residue[r];
+		n = n_contacts[j];
+		if (n > 4)
 			{
-			printf("residue %d (%s %d:%c) has > 4 contacts; looking for holes\n",
+			if (setflag[flag_v] || setflag[flag_l])
+				printf("residue %d (%s %d:%c) has > 4 contacts; looking for holes\n",
 				j,helix_residue_name[j],helix_residue_no[j],helix_chain[helix_no[j]]);
-			pos[0] = 0; best[0] = -1;
-			i = 0;
-			while (++i < 4) { best[i] = -1; pos[i] = pos[i-1] + 1;	}
-			ok = 1;
 
-			while (ok)
+			/* sort the contacts (and their distances) by residue-key */
+			for (i = 1; i < n; i++)
 				{
-				/*for (i = 0; i < 4; i++) printf("\t%d",pos[i]);
-				printf("\n");*/
-
-				/* There are N (= n_contacts[j]) positions to test; all possible
-				groups of 4 of them are tested (until a 3,1,3 spacing is found)
-				The current selection is held in pos[]. */
-
-				if (contact[j][pos[2]] == contact[j][pos[1]] + 1)
+				x = contact[j][i]; d = contact_distance[j][i];
+				for (k = i; (k > 0) && (contact[j][k-1] > x); k--)
 					{
-					/* save this combination */
-					for (i = 0; i < 4; i++) best[i] = pos[i];
-					/* now test it for 3,1,3 spacing */
-					if ((contact[j][pos[1]] == contact[j][pos[0]] + 3) &&
-						(contact[j][pos[3]] == contact[j][pos[2]] + 3))
-						{
-						ok = 0; break;
-						}
+					contact[j][k] = contact[j][k-1];
+					contact_distance[j][k] = contact_distance[j][k-1];
 					}
+				contact[j][k] = x; contact_distance[j][k] = d;
+				}
+
+			best[0] = -1;
 
-				i = 3;
-				while (++pos[i] == n_contacts[j] + i - 3)
+			/* the first x for which x, x+3, x+4 and x+7 are all
+			contacts; p1 and p3 only ever move forward */
+			p1 = p3 = 0;
+			for (i = 0; i < n; i++)
+				{
+				x = contact[j][i];
+				while ((p1 < n) && (contact[j][p1] < x + 3)) p1++;
+				while ((p3 < n) && (contact[j][p3] < x + 7)) p3++;
+				if (p3 == n) break;
+				if ((contact[j][p1] == x + 3) && (contact[j][p1+1] == x + 4)
+					&& (contact[j][p3] == x + 7))
 					{
-					if (--i < 0) { ok = 0; break;}
+					best[0] = i; best[1] = p1; best[2] = p1 + 1; best[3] = p3;
+					break;
 					}
-
-				if (i < 3)
-					while (++i < 4) pos[i] = pos[i-1] + 1;
 				}
 
+			/* otherwise, the last consecutive pair with a contact
+			either side of it */
+			if (best[0] == -1)
+				for (i = n - 3; i > 0; i--)
+					if (contact[j][i+1] == contact[j][i] + 1)
+						{
+						best[0] = i - 1; best[1] = i; best[2] = i + 1; best[3] = n - 1;
+						break;
+						}
+
 			if (best[0] != -1)
 				{
-
-				printf("contacts: ");
-				for (i = 0; i < n_contacts[j]; i++)
-					printf("%d) %s %d:%c iCode='%c'\t",i, helix_residue_name[contact[j][i]],helix_residue_no[contact[j][i]],
-						helix_chain[helix_no[contact[j][i]]], helix_residue_iCode[contact[j][i]]);
-
+				if (setflag[flag_v] || setflag[flag_l])
+					{
+					printf("contacts: ");
+					for (i = 0; i < n; i++)
+						printf("%d) %s %d:%c iCode='%c'\t",i, helix_residue_name[contact[j][i]],helix_residue_no[contact[j][i]],
+							helix_chain[helix_no[contact[j][i]]], helix_residue_iCode[contact[j][i]]);
 					printf("\n- includes hole:\n");
-					for (i = 0; i < 4; i++)
-						{
-						contact[j][i] = contact[j][best[i]];
+					}
+
+				/* best[] is increasing, so the group can be moved down
+				in place; the distances go with their contacts */
+				for (i = 0; i < 4; i++)
+					{
+					contact[j][i] = contact[j][best[i]];
+					contact_distance[j][i] = contact_distance[j][best[i]];
+					if (setflag[flag_v] || setflag[flag_l])
 						printf("%s %d:%c iCode='%c'\t",helix_residue_name[contact[j][i]],helix_residue_no[contact[j][i]],
 						helix_chain[helix_no[contact[j][i]]], helix_residue_iCode[contact[j][i]]);
-						}
+					}
 
-					printf("\n\n");
+				if (setflag[flag_v] || setflag[flag_l]) printf("\n\n");
 				}
 
 			}
 		}
 	}
 
-void report_kih(int residue_index)
+void report_kih()
 	{
-	int i,j;
+	int i,j,r;
 
 	if (setflag[flag_v] || setflag[flag_l])
 		{
-		for (i = 0; i < residue_index; i++)
-			if (n_contacts[i] > 3)
+		for (r = 0; r < pair_residues; r++)
+			if (n_contacts[pair_residue[r]] > 3)
 				{
 				printf("knobs\t\t\t\tholes\n-----\t\t\t\t-----\n\n");
 				break;
 				}
 		}
 
-	for (i = 0; i < residue_index; i++)
-
+	for (r = 0; r < pair_residues; r++)
+		{
+		i = pair_residue[r];
 		if (n_contacts[i] > 3)
 			{
 			/* this residue (i) is touching at least 4 other side chains
@@ -442,12 +515,13 @@ void report_kih(int residue_index)
 					helix_residue_iCode[contact[i][j]],
 					helix_no[contact[i][j]]);
 
-				hole[knob_index][j] = contact[i][j];
-				hole_distance[knob_index][j] = contact_distance[i][j];
+				/* only the first 4 (the best group; see best_kih()) form the hole */
+				if (j < 4) knob[knob_index].hole[j] = contact[i][j];
 				}
 
-			knobtype[knob_index] = 0;
-			knob[knob_index] = i;
+			knob[knob_index].type = 0;
+			knob[knob_index].residue = i;
+			measure_knob(knob_index);
 			n_hole_res[helix_no[contact[i][0]]]++;
 
 			if (setflag[flag_debug])
@@ -466,7 +540,7 @@ void report_kih(int residue_index)
 
 			if (contact[i][2] == (contact[i][1] + 1))
 				{
-				knobtype[knob_index]++;
+				knob[knob_index].type++;
 
 				/* give a warning if its not a x,x+3,x+4,x+7 spacing */
 
@@ -487,36 +561,34 @@ void report_kih(int residue_index)
 					  is necessarily < 7.0A, if the k is in the h;
 					this mean distance is calculated by the measure_k_end_h_CA() function. */
 
-				if (measure_k_end_h_CA(knob_index) < 7.0) /* XXX get rid of this naughty hardcoded constant */
+				if (knob_geometry[knob_index].end_distance < 7.0) /* XXX get rid of this naughty hardcoded constant */
 					{
-					knobtype[knob_index]++;
+					knob[knob_index].type++;
 					}
 
 				else if (setflag[flag_v] || setflag[flag_l]) printf("knob not in hole");
-				angle[knob_index] = packing_angle(i,contact[i][1],contact[i][2]);
 				}
 			if (setflag[flag_v] || setflag[flag_l]) printf("\n");
-			if (knobtype[knob_index]) knob_index++;
+			if (knob[knob_index].type) knob_index++;
 			}
+		}
 	}
 
-void check_complementarity()
+void check_complementarity(int residue_index)
 	{
-	int i,j,k,l,m,n,comp;
-	for (i = 0; i < knob_index; i++) n_compknob[i] = 0;
+	int i,j,k,l,m,comp;
+	for (i = 0; i < knob_index; i++) knob[i].n_compknob = 0;
 
-	daisy_chains = 0;
-	for (i = 0; i < MAX_DAISY_CHAINS; i++)
-		for (j = 0; j < MAX_DAISIES; j++) daisy_chain[i][j] = -1;
+	index_knobs(residue_index);
 
 	for (i = 0; i < knob_index; i++)
 		{
 		if (setflag[flag_v] || setflag[flag_l])
-			printf("checking knob\t%d (%s\t%d:%c iCode='%c', helix\t%d)",i,helix_residue_name[knob[i]],
-			helix_residue_no[knob[i]], helix_chain[helix_no[knob[i]]],
-			helix_residue_iCode[knob[i]], helix_no[knob[i]]);
+			printf("checking knob\t%d (%s\t%d:%c iCode='%c', helix\t%d)",i,helix_residue_name[knob[i].residue],
+			helix_residue_no[knob[i].residue], helix_chain[helix_no[knob[i].residue]],
+			helix_residue_iCode[knob[i].residue], helix_no[knob[i].residue]);
 
-		knob_order[i] = -1;
+		knob[i].order = -1;
 
 		for (j = 1; j < 3; j++)
 			{
@@ -524,88 +596,28 @@ void check_complementarity()
 
 			if (comp != -1)
 				{
-				if (n_compknob[i] == 3) { printf("!!this knob has > 3 **complementary** knobs - something is seriously wrong (even 3 is pretty unbelievable) - have you used a stupidly large cutoff? These are the complementary knobs:\n");
-					for (j = 0; j < 3; j++) printf("%d, ",compknob[i][j]); printf("%d\n",comp);
+				if (knob[i].n_compknob == 3) { printf("!!this knob has > 3 **complementary** knobs - something is seriously wrong (even 3 is pretty unbelievable) - have you used a stupidly large cutoff? These are the complementary knobs:\n");
+					for (j = 0; j < 3; j++) printf("%d, ",knob[i].compknob[j]); printf("%d\n",comp);
 					exit(1);
 					}
-				compknob[i][n_compknob[i]++] = comp;
-				knobtype[i] += 2;
-				if ((knobtype[i] > 4) && (setflag[flag_v] || setflag[flag_l])) printf(" DOUBLE type %d",knobtype[i]);
+				knob[i].compknob[knob[i].n_compknob++] = comp;
+				knob[i].type += 2;
+				if ((knob[i].type > 4) && (setflag[flag_v] || setflag[flag_l])) printf(" DOUBLE type %d",knob[i].type);
 
-				knob_order[i] = 2;
+				knob[i].order = 2;
 
 				if (setflag[flag_v] || setflag[flag_l]) printf(" complementary with knob %d",comp);
 				}
 			}
 		if (setflag[flag_v] || setflag[flag_l]) printf("\n");
-
-		for (n = 1; n > -2; n -= 2)
-			{
-
-			if (daisy_chains == MAX_DAISY_CHAINS)
-				{
-				printf("Maximum number of daisy chains (%d) exceeded\n",MAX_DAISY_CHAINS);
-				exit(1);
-				}
-
-			k = check_daisy_chain(i,0,daisy_chain[daisy_chains],n);
-
-			if (k >= 0)
-				{
-				knob_order[i] = k;
-			/* its possible that the daisy chain thats just been found is an identical copy of a previously
-			discovered chain, but with the knobs listed in a different order. The following checks this and
-			if its the case, the latest chain found is discarded. NB this is distinct from the case of a
-			knob being part of two different chains, which is possible eg in gp41-like arrangements where
-			the central 3 helices each simultaneously belong to two different 3-strand coiled coils.
-
-			The first thing to do is sort the knobs belonging to the chain, which makes it easier to compare them */
-
-				/* start of sort routine */
-
-				l = 1;
-				while (l)
-					{
-					l = 0;
-					for (j = 1; j < k; j++)
-						if (daisy_chain[daisy_chains][j] < daisy_chain[daisy_chains][j-1])
-							{
-							l = daisy_chain[daisy_chains][j];
-							daisy_chain[daisy_chains][j] = daisy_chain[daisy_chains][j-1];
-							daisy_chain[daisy_chains][j-1] = l;
-							l = 1;
-							}
-					}
-				/* end of sort routine */
-
-
-				k = 0; /* k flags whether or not an identical daisy-chain has been found */
-				j = 0; while ((j < daisy_chains) && (!k))
-					{
-					k = 1; l = 0;
-					while ((daisy_chain[daisy_chains][l] != -1) && (k) && (l < MAX_DAISIES))
-						{
-						if (daisy_chain[daisy_chains][l] != daisy_chain[j][l]) k = 0;
-						l++;
-						}
-					j++;
-					}
-				if (k)	{for (j = 0; j < MAX_DAISIES; j++) daisy_chain[daisy_chains][j] = -1; }
-				else daisy_chains++;
-				}
-
-			else for (j = 0; j < MAX_DAISIES; j++)
-				daisy_chain[daisy_chains][j] = -1;
-
-			}
-
 		}
 
+	/* the daisy chains (closed, non pairwise complementary, cycles of knob-into-hole
+		interactions) are all found at once, as the cycles of the knob-into-hole graph;
+		see daisies.c */
 
-
-	/* only report 'daisy-chains' (closed, non pairwise complementary, cycles of knob-into-hole interactions),
-		when all the daisy-chains have been collected (done in the above i=0..knob_index loop) */
-
+	build_knob_graph();
+	find_daisy_chains();
 
 	if (setflag[flag_v])
 		for (i = 0; i < daisy_chains; i++)
@@ -621,7 +633,7 @@ void check_complementarity()
 		{
 		printf("daisy chain %2d : knobs ",i);
 		j = -1; while ((daisy_chain[i][++j] != -1) && (j < MAX_DAISIES))
-			printf("%2d (helix %2d)\t",daisy_chain[i][j],helix_no[knob[daisy_chain[i][j]]]);
+			printf("%2d (helix %2d)\t",daisy_chain[i][j],helix_no[knob[daisy_chain[i][j]].residue]);
 		printf("\n");
 		}
 
@@ -640,19 +652,19 @@ void check_complementarity()
 					if (l == -1)
 						{
 						if (!setflag[flag_q])
-						printf("knob %3d (residue %d = %s %d:%c iCode='%c')",i,knob[i],helix_residue_name[knob[i]],
-						helix_residue_no[knob[i]],helix_chain[helix_no[knob[i]]],helix_residue_iCode[knob[i]]);
-						if (knobtype[i] < 3) {
+						printf("knob %3d (residue %d = %s %d:%c iCode='%c')",i,knob[i].residue,helix_residue_name[knob[i].residue],
+						helix_residue_no[knob[i].residue],helix_chain[helix_no[knob[i].residue]],helix_residue_iCode[knob[i].residue]);
+						if (knob[i].type < 3) {
 							/* turn any knobs of type 1 or 2 into proper knobs (3 or 4) */
-							knobtype[i] += 2;
+							knob[i].type += 2;
 							/* this while loop puts the knobs (apart from knob i itself)
 							into the compknob array for knob i (while theres room) */
 							}
 						m = 0;
 						while ((daisy_chain[j][m] != -1) && (m < MAX_DAISIES))
 							{
-							if ((daisy_chain[j][m] != i) && (n_compknob[i] < MAX_COMPKNOBS))
-								compknob[i][n_compknob[i]++] = daisy_chain[j][m];
+							if ((daisy_chain[j][m] != i) && (knob[i].n_compknob < MAX_COMPKNOBS))
+								knob[i].compknob[knob[i].n_compknob++] = daisy_chain[j][m];
 							m++;
 							}
 						}
@@ -661,6 +673,20 @@ void check_complementarity()
 				k++;
 				}
 			if (l == j) {
+
+				/* knob i is in daisy chain j, which has k knobs; a knob which is
+				part of more than one complementary arrangement (e.g. cyclically
+				complementary with other core knobs, but pairwise complementary
+				with a peripheral knob, or part of two daisy chains, as in Stat3B
+				1bg1 where Leu 221:A is in two 3-membered chains) takes the order
+				of the largest. As every daisy chain has been enumerated, this is
+				simply the maximum over the chains listed here. (In earlier
+				versions, each knob's order was that of the single chain traced
+				from it, which could fail to close (order -2), and had to be
+				patched up afterwards from the list of daisy chains) */
+
+				if (k > knob[i].order) knob[i].order = k;
+
 				if (!setflag[flag_q]) {printf(" forms a %d-knob cycle with knobs ",k);
 				k = 0; while ((daisy_chain[j][k] != -1) && (k < MAX_DAISIES)) {printf("%4d",daisy_chain[j][k]); k++;}
 				printf("; ");}
@@ -668,6 +694,11 @@ void check_complementarity()
 			}
 		if ((l != -1) && (!setflag[flag_q])) printf("\n");
 
+		/* (the note below is from the earlier versions, in which each knob
+		was given the order of the chain traced from it; every daisy chain
+		is now enumerated, see daisies.c, so no knob is left with order -2,
+		and the patch-up pass it describes is gone) */
+
 		/* it is possible that a knob in a daisy chain has ended up with an order of -2.
 		For example, Leu 305:A in Stat3B 1bg1. In this structure there are knobs which
 		are simultaneously part of 2 daisy chains:
@@ -751,56 +782,55 @@ void check_complementarity()
 		checked; their knob-order will only be changed if the order of
 		the daisy chain they are in is greater than their current order
 		 */
-
-			for (j = 0; j < daisy_chains; j++)
-				{
-				k = 0;
-				while ((daisy_chain[j][k] != -1)
-					&& (daisy_chain[j][k] != i)
-					&& (k < MAX_DAISIES))
-					k++;
-				if (daisy_chain[j][k] == i)
-					/* knob i is in daisy chain j; what order is daisy chain j? */
-					{
-					k = 0; while ((daisy_chain[j][k] != -1) && (k < MAX_DAISIES)) k++;
-					if (k > knob_order[i])
-						{
-						if (!setflag[flag_q])
-							printf("order of knob %d was %d; changing to %d\n",i,knob_order[i],k);
-						knob_order[i] = k;
-						}
-					}
-				}
 		}
 
 	}
 
 
-int complementary(int knobno, int holeresno)
+void index_knobs(int residue_index)
 	{
-	int i,done;
-	done = -2;
-	i = 0;
-	/*printf("doing complementary(%d,%d)\n",knobno,holeresno);*/
-	while ((done == -2) && (i < knob_index))
+	int h,i,k,r;
+
+	/* a counting sort of the knob-keys by residue-key; knobs at the same
+	residue (duplicate knobs) stay in order of knob-key */
+
+	for (r = 0; r <= residue_index; r++) residue_knob_start[r] = 0;
+	for (k = 0; k < knob_index; k++) residue_knob_start[knob[k].residue+1]++;
+	for (r = 0; r < residue_index; r++) residue_knob_start[r+1] += residue_knob_start[r];
+	for (k = 0; k < knob_index; k++) residue_knob[residue_knob_start[knob[k].residue]++] = k;
+
+	/* each residue_knob_start[r] has now been advanced to the start of
+	residue r+1; shift them all back */
+	for (r = residue_index; r > 0; r--) residue_knob_start[r] = residue_knob_start[r-1];
+	residue_knob_start[0] = 0;
+
+	/* and the same again by helix-key, taking the knobs in the order of
+	residue_knob[], so that each helix's knobs are in residue order */
+
+	for (h = 0; h <= helix_index; h++) helix_knob_start[h] = 0;
+	for (k = 0; k < knob_index; k++) helix_knob_start[helix_no[knob[k].residue]+1]++;
+	for (h = 0; h < helix_index; h++) helix_knob_start[h+1] += helix_knob_start[h];
+	for (i = 0; i < knob_index; i++)
 		{
-/*printf("bigloop i = %d\n",i);*/
-		while ((i < knob_index) && (knob[i] != hole[knobno][holeresno])) i++; 
-		/* if the below is true, then the holeresno'th residue of the hole
-			which contains knob knobno isnt a knob at all */
-		if /*(knob[i] != hole[knobno][holeresno])*/ (i == knob_index) done = -1;
-		else
-			{
-			/* so the hole residue is also a knob, but is it a knob with
-			knob knobno as either the 2nd or 3rd residue of the hole? */
-			if ((hole[i][1] == knob[knobno]) || (hole[i][2] == knob[knobno]))
-				{
-				done = i;
-				}
-			else i++;
-			}
+		k = residue_knob[i];
+		helix_knob[helix_knob_start[helix_no[knob[k].residue]]++] = k;
 		}
-	if (done == -2) done++;
-	return done;
+	for (h = helix_index; h > 0; h--) helix_knob_start[h] = helix_knob_start[h-1];
+	helix_knob_start[0] = 0;
 	}
 
+
+int complementary(int knobno, int holeresno)
+	{
+	int i,r;
+
+	/* is the holeresno'th residue of the hole which contains knob knobno
+	also a knob (see index_knobs()), and is it a knob with knob knobno as
+	either the 2nd or 3rd residue of its hole? */
+
+	r = knob[knobno].hole[holeresno];
+	for (i = residue_knob_start[r]; i < residue_knob_start[r+1]; i++)
+		if ((knob[residue_knob[i]].hole[1] == knob[knobno].residue) || (knob[residue_knob[i]].hole[2] == knob[knobno].residue))
+			return residue_knob[i];
+	return -1;
+	}
@@ -0,0 +1,120 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					legacy.c
+
+
+Description: this C program identifies coiled-coil motifs in a Protein Data Bank
+(Berman et al, Nucleic Acids Res v28 pp235-42, 2000) file. Also required as
+input is a DSSP (Kabsch & Sander, Biopolymers v22 pp 2577-637) file derived from
+the PDB file.
+
+
+*/
+
+/*					legacy.c
+					--------
+
+The legacy engines (--legacy): the straightforward forms of the contact search
+and of the choice of hole, as they were before they were optimized, kept so
+that the optimized engines can be checked against them (see bench/difftest.py,
+'make difftest'). Each does the same job as its optimized counterpart, and
+must give the same results, bit for bit; only the time taken differs.
+
+This is a check of self-consistency, not of correctness: an error in what both
+forms compute (as in the choice of hole, which once left the hole distances
+with the wrong residues) is not caught by it, and has checks of its own (see
+bench/holecheck.py). Nor is --legacy the original program: only these two
+engines are kept, and the rest of the analysis is the current one. The results
+are compared with those of the original program, built from the baseline
+commit, by 'make difftest' too (see difftest.py's --baseline).
+
+	legacy_contacts()	as reset_contacts() and measure_helix_pair():
+				clears the contacts of every residue, and then
+				finds the residues of each helix by scanning all
+				the residues, rather than from helix_residue[]
+
+	legacy_best_kih()	as best_kih(): tries every group of 4 contacts of
+				every residue with more than 4, in the order in
+				which they are found, rather than scanning the
+				sorted contacts once
+
+The unpruned daisy chain search is in daisies.c (see find_daisy_chains()), as it
+shares its storage with the optimized one. It is the search for cycles of the
+knob-into-hole graph without the pruning to strongly connected components; it
+is not the recursive tracer (check_daisy_chain()) that the cycle search
+replaced, which finds a different set of daisy chains, and so cannot be
+compared with it.
+*/
+
+#include "socket.h"
+
+
+void legacy_contacts(int helix1, int helix2, int residue_index)
+	{
+	int i,j;
+
+	for (i = 0; i < residue_index; i++) n_contacts[i] = 0;
+
+	for (i = 0; i < residue_index; i++)
+		if (helix_no[i] == helix1)
+			for (j = 0; j < residue_index; j++)
+				if (helix_no[j] == helix2)
+					measure_residue_pair(i,j);
+	}
+
+
+void legacy_best_kih(int residue_index)
+	{
+	int pos[4], best[4], i,j, ok;
+
+	for (j = 0; j < residue_index; j++)
+		{
+		if (n_contacts[j] > 4)
+			{
+			pos[0] = 0; best[0] = -1;
+			i = 0;
+			while (++i < 4) { best[i] = -1; pos[i] = pos[i-1] + 1;	}
+			ok = 1;
+
+			while (ok)
+				{
+				/* There are N (= n_contacts[j]) positions to test; all possible
+				groups of 4 of them are tested (until a 3,1,3 spacing is found)
+				The current selection is held in pos[]. */
+
+				if (contact[j][pos[2]] == contact[j][pos[1]] + 1)
+					{
+					/* save this combination */
+					for (i = 0; i < 4; i++) best[i] = pos[i];
+					/* now test it for 3,1,3 spacing */
+					if ((contact[j][pos[1]] == contact[j][pos[0]] + 3) &&
+						(contact[j][pos[3]] == contact[j][pos[2]] + 3))
+						{
+						ok = 0; break;
+						}
+					}
+
+				i = 3;
+				while (++pos[i] == n_contacts[j] + i - 3)
+					{
+					if (--i < 0) { ok = 0; break;}
+					}
+
+				/* (i < 0 once every group has been tried) */
+				if ((i >= 0) && (i < 3))
+					while (++i < 4) pos[i] = pos[i-1] + 1;
+				}
+
+			/* the distances go with their contacts (best[] is increasing) */
+			if (best[0] != -1)
+				for (i = 0; i < 4; i++)
+					{
+					contact[j][i] = contact[j][best[i]];
+					contact_distance[j][i] = contact_distance[j][best[i]];
+					}
+			}
+		}
+	}
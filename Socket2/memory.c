@@ -0,0 +1,141 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					memory.c
+
+
+Description: this C program identifies coiled-coil motifs in a Protein Data Bank
+(Berman et al, Nucleic Acids Res v28 pp235-42, 2000) file. Also required as
+input is a DSSP (Kabsch & Sander, Biopolymers v22 pp 2577-637) file derived from
+the PDB file.
+
+
+*/
+
+/*					memory.c
+					--------
+
+Where the memory goes (--mem-report). Nearly all of SOCKET's data is in the
+fixed-size arrays of global.h, reserved whether or not a structure needs them,
+so the resident size of a run says little about how much is in use.
+report_memory() writes, for each of the major structures, the bytes which the
+entry actually uses against the bytes reserved for it, and then the peak
+resident set size of the process, on lines for batch runs to collect:
+
+	MEMORY <code> <structure> used=<bytes> reserved=<bytes>
+	MEMORY <code> total used=<bytes> reserved=<bytes> peak_rss=<bytes>
+
+The structures are:
+
+	atoms		the atoms of the helical residues (none with -m)
+	residues	the helical residues: names, numbers, reference atoms
+			and positions
+	contacts	the residues in contact with each residue, and their
+			distances; these are reset for each pair of helices,
+			so what is used is as many columns as any residue has
+			ever filled (GLOBAL contacts_high_water), for every
+			residue
+	helices		the helices, and the orientation of each pair of them
+	knobs		the knobs, their geometry, and the indexes and graph
+			built on them
+	daisy_chains	the daisies of each daisy chain
+	coiled_coils	the helices of each coiled coil, and their extents
+	registers	the heptad registers (see register.c)
+
+A row of a two-dimensional array (e.g. the contacts of a residue) counts as used
+only as far as it is filled.
+*/
+
+#include "socket.h"
+#include <sys/resource.h>
+
+
+static long total_used, total_reserved;
+
+
+static void memory_line(char structure[], long used, long reserved)
+	{
+	printf("MEMORY %s %s used=%ld reserved=%ld\n",code,structure,used,reserved);
+	total_used += used;
+	total_reserved += reserved;
+	}
+
+
+void report_memory(int residue_index, int atom_index)
+	{
+	int c,d,n;
+	long used,reserved;
+	struct rusage usage;
+
+	if (!setflag[flag_mem_report]) return;
+	total_used = total_reserved = 0;
+
+	/* the atoms are not kept with -m */
+	reserved = sizeof(atom_no) + sizeof(atom_res) + sizeof(atom_name) +
+		sizeof(atom_class) + sizeof(coord);
+	used = setflag[flag_m] ? 0 : (long) atom_index * (reserved / MAX_ATOMS);
+	memory_line("atoms",used,reserved);
+
+	/* all of these are MAX_RESIDUES long */
+	reserved = sizeof(refatom0) + sizeof(refatom1) + sizeof(refatom2) + sizeof(refatom3) +
+		sizeof(residue_geometry) + sizeof(helix_residue_no) + sizeof(helix_no) +
+		sizeof(helix_residue_aacode) + sizeof(n_contacts) + sizeof(helix_residue_name) +
+		sizeof(helix_residue_iCode) + sizeof(helix_residue);
+	memory_line("residues",(long) residue_index * (reserved / MAX_RESIDUES),reserved);
+
+	used = (long) residue_index * contacts_high_water *
+		(sizeof(contact[0][0]) + sizeof(contact_distance[0][0]));
+	memory_line("contacts",used,sizeof(contact) + sizeof(contact_distance));
+
+	reserved = sizeof(helix_start) + sizeof(helix_end) + sizeof(helix_N_residue) +
+		sizeof(helix_C_residue) + sizeof(n_knobs) + sizeof(n_hole_res) +
+		sizeof(helix_order) + sizeof(n_knobtype) + sizeof(n_holetype) + sizeof(helix_chain) +
+		sizeof(helix_start_iCode) + sizeof(helix_end_iCode) + sizeof(helix_axis);
+	used = (long) helix_index * (reserved / MAX_HELICES) +
+		(helix_index + 1) * sizeof(helix_residue_start[0]) +
+		(long) helix_index * helix_index * sizeof(helix_pair_orientation[0][0]);
+	reserved += sizeof(helix_residue_start) + sizeof(helix_pair_orientation);
+	memory_line("helices",used,reserved);
+
+	reserved = sizeof(knob) + sizeof(knob_geometry) + sizeof(residue_knob) +
+		sizeof(helix_knob) + sizeof(knob_link_start) + sizeof(knob_link) +
+		sizeof(residue_knob_start) + sizeof(helix_knob_start) + sizeof(duplicate_residue);
+	used = (long) knob_index * (sizeof(knob[0]) + sizeof(knob_geometry[0]) +
+		sizeof(residue_knob[0]) + sizeof(helix_knob[0]) + sizeof(knob_link_start[0])) +
+		sizeof(knob_link_start[0]) + knob_link_start[knob_index] * sizeof(knob_link[0]) +
+		(residue_index + 1) * sizeof(residue_knob_start[0]) +
+		(helix_index + 1) * sizeof(helix_knob_start[0]) +
+		n_duplicate_knobs * sizeof(duplicate_residue[0]);
+	memory_line("knobs",used,reserved);
+
+	used = (long) daisy_chains * sizeof(daisy_chain_cc[0]);
+	for (d = 0; d < daisy_chains; d++)
+		{
+		for (n = 0; (n < MAX_DAISIES) && (daisy_chain[d][n] != -1); n++);
+		used += n * sizeof(daisy_chain[0][0]);
+		}
+	memory_line("daisy_chains",used,sizeof(daisy_chain) + sizeof(daisy_chain_cc));
+
+	reserved = sizeof(coiled_coil_tally) + sizeof(coiled_coil_helices) +
+		sizeof(coiled_coil_subset) + sizeof(coiled_coil_orientation) +
+		sizeof(coiled_coil_max_length) + sizeof(coiled_coil_mean_length);
+	used = (long) coiled_coils * (reserved / MAX_COILED_COILS);
+	for (c = 0; c < coiled_coils; c++)
+		used += coiled_coil_helices[c] * (sizeof(coiled_coil[0][0]) +
+			sizeof(coiled_coil_begin[0][0]) + sizeof(coiled_coil_end[0][0]));
+	reserved += sizeof(coiled_coil) + sizeof(coiled_coil_begin) + sizeof(coiled_coil_end);
+	memory_line("coiled_coils",used,reserved);
+
+	register_footprint(&used,&reserved);
+	used += (residue_index + 1) * sizeof(residue_register_start[0]) +
+		residue_register_start[residue_index] * sizeof(residue_register_cc[0]);
+	reserved += sizeof(residue_register_start) + sizeof(residue_register_cc);
+	memory_line("registers",used,reserved);
+
+	/* ru_maxrss is in kilobytes on Linux */
+	getrusage(RUSAGE_SELF,&usage);
+	printf("MEMORY %s total used=%ld reserved=%ld peak_rss=%ld\n",code,total_used,
+		total_reserved,usage.ru_maxrss * 1024L);
+	}
@@ -33,10 +33,128 @@ the PDB file.
 #include "socket.h"
 #include <string.h>
 #include <stdlib.h>
+
+/* the sets of helices of the coiled coils are held as bitsets, one per helix,
+of the coiled coils to which each helix belongs; so the coiled coils of which
+coiled coil i is a subset are found by AND-ing the bitsets of its helices
+together, a word (32 coiled coils) at a time */
+
+#define COILED_COIL_WORDS ((MAX_COILED_COILS + 31) / 32)
+
+static unsigned int	helix_coiled_coils[MAX_HELICES][COILED_COIL_WORDS];	/* bit k
+						of helix h's bitset is set if helix h
+						is in coiled coil k */
+static int	coiled_coil_hash[COILED_COIL_HASH_SIZE],	/* hash set of the
+						helix combinations in coiled_coil[][]:
+						coiled-coil id, or -1 if the slot is
+						empty */
+		coiled_coil_hash_length[COILED_COIL_HASH_SIZE],	/* the number
+						of helices in each slot */
+		subset_first[MAX_COILED_COILS],		/* the first coiled coil
+							whose coiled_coil_subset is
+							each coiled coil; -1 if none */
+		subset_next[MAX_COILED_COILS],		/* the next one, so that
+							these form linked lists */
+		daisy_first[MAX_COILED_COILS],		/* likewise, the daisy
+							chains whose daisy_chain_cc
+							is each coiled coil */
+		daisy_next[MAX_DAISY_CHAINS];
+
+
+/* FNV-1a over the helix ids, and then the number of them */
+
+#define FNV_PRIME 16777619u
+#define FNV_BASIS 2166136261u
+
+
+/* the slot of the hash set holding the n helices helix[0..n-1], whose hash is
+hash, or the empty slot where they would go */
+
+static int coiled_coil_slot(int helix[], int n, unsigned int hash)
+	{
+	int k,m,slot;
+
+	for (slot = hash & (COILED_COIL_HASH_SIZE - 1); coiled_coil_hash[slot] != -1;
+		slot = (slot + 1) & (COILED_COIL_HASH_SIZE - 1))
+		{
+		if (coiled_coil_hash_length[slot] != n) continue;
+		k = coiled_coil_hash[slot];
+		for (m = 0; (m < n) && (coiled_coil[k][m] == helix[m]); m++);
+		if (m == n) return slot;
+		}
+	return slot;
+	}
+
+
+/* adds the combination of the n helices in helix[] (in ascending order) to the
+coiled_coil list, or, if it is already there, increments its tally; returns its
+coiled-coil id.
+
+A combination is 'already there' only if a coiled coil has exactly its helices
+(the original linear search of the list took the first coiled coil whose
+leading n helices matched, so that a daisy chain of 3 helices was counted as
+the 4-helix coiled coil it begins, if that was found first; see
+bench/ordercheck.py) */
+
+static int add_coiled_coil(int helix[], int n)
+	{
+	int m,slot;
+	unsigned int hash;
+
+	hash = FNV_BASIS;
+	for (m = 0; m < n; m++) hash = (hash ^ (unsigned int) helix[m]) * FNV_PRIME;
+	slot = coiled_coil_slot(helix,n,(hash ^ (unsigned int) n) * FNV_PRIME);
+	if (coiled_coil_hash[slot] != -1)
+		{
+		coiled_coil_tally[coiled_coil_hash[slot]]++;
+		return coiled_coil_hash[slot];
+		}
+
+	if (coiled_coils == MAX_COILED_COILS)
+		{ printf("maximum number of coiled coils (%d) exceeded\n\n",MAX_COILED_COILS); exit(1);}
+	for (m = 0; m < n; m++)
+		{
+		coiled_coil[coiled_coils][m] = helix[m];
+		helix_coiled_coils[helix[m]][coiled_coils >> 5] |= 1u << (coiled_coils & 31);
+		}
+	coiled_coil_subset[coiled_coils] = -1;
+	coiled_coil_helices[coiled_coils] = n;
+	coiled_coil_tally[coiled_coils] = 1;
+	coiled_coil_hash[slot] = coiled_coils;
+	coiled_coil_hash_length[slot] = n;
+	return coiled_coils++;
+	}
+
+
+/* all the coiled coils whose coiled_coil_subset is coiled coil i, and all the
+daisy chains whose daisy_chain_cc is i, are moved over to coiled coil t */
+
+static void move_subsets(int i, int t)
+	{
+	int l;
+
+	while ((l = subset_first[i]) != -1)
+		{
+		subset_first[i] = subset_next[l];
+		coiled_coil_subset[l] = t;
+		subset_next[l] = subset_first[t];
+		subset_first[t] = l;
+		}
+	while ((l = daisy_first[i]) != -1)
+		{
+		daisy_first[i] = daisy_next[l];
+		daisy_chain_cc[l] = t;
+		daisy_next[l] = daisy_first[t];
+		daisy_first[t] = l;
+		}
+	}
+
+
 int determine_order(/*int residue_index*/)
 	{
 	/* determines the oligomerization state of the coiled coils */
-	int i, j, k, l, m, helix[MAX_DAISIES];
+	int i, j, k, l, m, helix[MAX_DAISIES], first, last;
+	unsigned int supersets[COILED_COIL_WORDS], word;
 
 	/* function uses these global variables:
 	coiled_coil[MAX_COILED_COILS][6]
@@ -56,9 +174,7 @@ int determine_order(/*int residue_index*/)
 	and:		
 	knob_index
 	knob_threshold
-	knob[]
-	knobtype[]
-	knob_order[]
+	knob[] (residue, type, order, compknob[])
 	helix_residue_name[]
 	helix_residue_no[]
 	helix_chain[]
@@ -69,48 +185,32 @@ int determine_order(/*int residue_index*/)
 	*/
 
 	coiled_coils = 0;
+	for (i = 0; i < helix_index; i++)
+		for (k = 0; k < COILED_COIL_WORDS; k++) helix_coiled_coils[i][k] = 0;
+	for (i = 0; i < COILED_COIL_HASH_SIZE; i++) coiled_coil_hash[i] = -1;
 
 	/* first compile list of all pairwise coiled-coil interactions */
 
 	for (i = 0; i < knob_index; i++)
 		{
 		if (!setflag[flag_q]) printf("knob %3d (residue %d = %s %d:%c iCode='%c') type %d order %d\n",
-			i,knob[i],helix_residue_name[knob[i]],
-			helix_residue_no[knob[i]],helix_chain[helix_no[knob[i]]],
-			helix_residue_iCode[knob[i]],knobtype[i],knob_order[i]);
+			i,knob[i].residue,helix_residue_name[knob[i].residue],
+			helix_residue_no[knob[i].residue],helix_chain[helix_no[knob[i].residue]],
+			helix_residue_iCode[knob[i].residue],knob[i].type,knob[i].order);
 
-		if (knobtype[i] >= knob_threshold)
+		if (knob[i].type >= knob_threshold)
 			{
-			if (helix_no[knob[i]] > helix_no[knob[compknob[i][0]]])
+			if (helix_no[knob[i].residue] > helix_no[knob[knob[i].compknob[0]].residue])
 				{
-				helix[0] = helix_no[knob[compknob[i][0]]];
-				helix[1] = helix_no[knob[i]];
+				helix[0] = helix_no[knob[knob[i].compknob[0]].residue];
+				helix[1] = helix_no[knob[i].residue];
 				}
 			else	{
-				helix[0] = helix_no[knob[i]];
-				helix[1] = helix_no[knob[compknob[i][0]]];
+				helix[0] = helix_no[knob[i].residue];
+				helix[1] = helix_no[knob[knob[i].compknob[0]].residue];
 				}
 
-			k = 0;
-			/* l signals whether this combination is found in the list */
-			l = 0;
-			while ((k < coiled_coils) && (!l))
-				{
-				l = 1;
-				for (m = 0; m < 2; m++) if (coiled_coil[k][m] != helix[m]) l = 0;
-				if (l) coiled_coil_tally[k]++;
-				k++;
-				}
-			if (!l)
-				{
-				if (coiled_coils == MAX_COILED_COILS)
-					{ printf("maximum number of coiled coils (%d) exceeded\n\n",MAX_COILED_COILS); exit(1);}
-				for (m = 0; m < 2; m++) coiled_coil[coiled_coils][m] = helix[m];
-				coiled_coil_subset[coiled_coils] = -1;
-				coiled_coil_helices[coiled_coils] = 2;
-				coiled_coil_tally[coiled_coils] = 1;
-				coiled_coils++;
-				}
+			add_coiled_coil(helix,2);
 			}
 			
 		}
@@ -133,12 +233,12 @@ int determine_order(/*int residue_index*/)
 		while ((daisy_chain[i][j] != -1) && (j < MAX_DAISIES))
 			{
 			/* the helix id of this knob in the daisy chain is
-			helix_no[knob[daisy_chain[i][j]]] ; add it to
+			helix_no[knob[daisy_chain[i][j]].residue] ; add it to
 			the helix[] array (in the correct order) */
 			k = 0;
-			while ((k < j) && (helix[k] < helix_no[knob[daisy_chain[i][j]]])) k++;
+			while ((k < j) && (helix[k] < helix_no[knob[daisy_chain[i][j]].residue])) k++;
 			for (l = j - 1; l >= k; l--) helix[l+1] = helix[l];
-			helix[k] = helix_no[knob[daisy_chain[i][j]]];
+			helix[k] = helix_no[knob[daisy_chain[i][j]].residue];
 			j++;
 			}
 		if (setflag[flag_v]) { printf("daisy chain %d; helices",i);
@@ -147,92 +247,81 @@ int determine_order(/*int residue_index*/)
 
 		/* the list of j helices which are part of this daisy chain is now
 		held in helix[] ; if this list is different to all those found so
-		far, add it to the coiled_coil array */
+		far, it is added to the coiled_coil array */
 
-		k = 0;
-		/* l signals whether this combination is found in the list */
-		l = 0;
-		while ((k < coiled_coils) && (!l))
-			{
-			l = 1;
-			/* printf("cf coiled coil %d:\t",k); */
-			if (setflag[flag_v]) for (m = 0; m < j; m++) printf("%d v %d; ",coiled_coil[k][m],helix[m]);
-			for (m = 0; m < j; m++) if (coiled_coil[k][m] != helix[m]) l = 0;
-			if (l)
-				{
-				coiled_coil_tally[k]++;
-				daisy_chain_cc[i] = k;
-				}
-			if (setflag[flag_v]) { if (l) printf("MATCHED\n"); else printf("different\n"); }
-			k++;
-			}
-		if (!l)
+		daisy_chain_cc[i] = add_coiled_coil(helix,j);
+		if (setflag[flag_v])
 			{
-			if (coiled_coils == MAX_COILED_COILS)
-				{ printf("maximum number of coiled coils (%d) exceeded\n\n",MAX_COILED_COILS); exit(1);}
-			for (m = 0; m < j; m++) coiled_coil[coiled_coils][m] = helix[m];
-			coiled_coil_subset[coiled_coils] = -1;
-			coiled_coil_helices[coiled_coils] = j;
-			coiled_coil_tally[coiled_coils] = 1;
-			daisy_chain_cc[i] = coiled_coils;
-			coiled_coils++;
+			if (coiled_coil_tally[daisy_chain_cc[i]] > 1)
+				printf("MATCHED coiled coil %d\n",daisy_chain_cc[i]);
+			else printf("new coiled coil %d\n",daisy_chain_cc[i]);
 			}
 		}
 
+	for (i = 0; i < coiled_coils; i++) subset_first[i] = -1;
+	for (i = 0; i < coiled_coils; i++) daisy_first[i] = -1;
+	for (i = 0; i < daisy_chains; i++)
+		{
+		daisy_next[i] = daisy_first[daisy_chain_cc[i]];
+		daisy_first[daisy_chain_cc[i]] = i;
+		}
+
 	for (i = 0; i < coiled_coils; i++)
 		{
 
 		/* check each combination of helices (coiled coil) - it might be
-		a subset of other coiled coils */
-		for (k = 0; k < coiled_coils; k++)
+		a subset of other coiled coils; the coiled coils which contain
+		all of its helices are those in the intersection of its helices'
+		bitsets (less itself) */
+		for (k = 0; k < COILED_COIL_WORDS; k++)
 			{
-			if (i != k)
-				{
-				/* l signals that the helices in coiled_coil_helices[i]
-				are all also present in array coiled_coil_helices[k] */
-				l = 1;
-				j = 0;
-				while ((j < coiled_coil_helices[i]) && (l))
+			word = helix_coiled_coils[coiled_coil[i][0]][k];
+			for (j = 1; j < coiled_coil_helices[i]; j++)
+				word &= helix_coiled_coils[coiled_coil[i][j]][k];
+			supersets[k] = word;
+			}
+		supersets[i >> 5] &= ~(1u << (i & 31));
+
+		first = last = -1;
+		for (k = 0; k < COILED_COIL_WORDS; k++)
+			for (word = supersets[k], m = 0; word; word >>= 1, m++)
+				if (word & 1)
 					{
-					l = 0;
-					m = 0;
-					while ((m < coiled_coil_helices[k]) && (!l))
-						if (coiled_coil[k][m++] == coiled_coil[i][j]) l = 1;
-					j++;
-					}
-				if (l)	{
-					/* coiled coil i is a subset of coiled coil k */
-					if (coiled_coil_subset[k] == -1)
-						coiled_coil_subset[i] = k;
-					else coiled_coil_subset[i] = coiled_coil_subset[k];
-					/* its just possible that other coiled coils have previously
-					   been assigned as subsets of coiled coil i ; so they
-					   must be found and their subsets changed to the new
-					   coiled_coil_subset[i] 
-					   eg coiled coil 1 consists of helices A, B
-					      coiled coil 2 consists of helices A, B, C, D
-					      coiled coil 3 consists of helices A, B, C
-					      1 is a subset of 2 and 3; 3 is a subset of 2
-					      (this arrangement is unlikely but does occur, eg 1sfc)
-					   when assigning coiled coil 1, it will first
-						have coiled_coil_subset[1] set to 2;
-                                                later it will be set to 3.
-                                           coiled coil 2 will remain with coiled_coil_subset[2] set to -1;
-                                           coiled coil 3 will have coiled_coil_subset[3] set to 2.
-                                           Therefore a second pass is needed to change coiled_coil_subset[1]
-					   from 3 to coiled_coil_subset[3] = 2.
-					   The point is, all values of coiled_coil_subset[] should be
-					   either -1, or the ID of a coiled coil X whose coiled_coil_subset[X] = -1.
-					   l is used to index this second pass. */
-					for (l = 0; l < coiled_coils; l++)
-						if (coiled_coil_subset[l] == i) coiled_coil_subset[l] = coiled_coil_subset[i];
-					/* also, the coiled coil ID of any daisy chains (daisy_chain_cc) whose daisy_chain_cc
-					is currently set to i, should also be changed to coiled_coil_subset[i];
-					l is sued to index the daisy chains */
-					for (l = 0; l < daisy_chains; l++)
-						if (daisy_chain_cc[l] == i) daisy_chain_cc[l] = coiled_coil_subset[i];
+					if (first == -1) first = 32 * k + m;
+					last = 32 * k + m;
 					}
-				}
+
+		if (first != -1)
+			{
+			/* coiled coil i is a subset of coiled coil k (of the last one,
+			   if there are several)
+			   its just possible that other coiled coils have previously
+			   been assigned as subsets of coiled coil i ; so they
+			   must be moved to the new coiled_coil_subset[i] 
+			   eg coiled coil 1 consists of helices A, B
+			      coiled coil 2 consists of helices A, B, C, D
+			      coiled coil 3 consists of helices A, B, C
+			      1 is a subset of 2 and 3; 3 is a subset of 2
+			      (this arrangement is unlikely but does occur, eg 1sfc)
+			   when assigning coiled coil 1, it will
+				have coiled_coil_subset[1] set to 3.
+                           coiled coil 2 will remain with coiled_coil_subset[2] set to -1;
+                           coiled coil 3 will have coiled_coil_subset[3] set to 2,
+                           and coiled_coil_subset[1] is moved from 3 to coiled_coil_subset[3] = 2.
+			   The point is, all values of coiled_coil_subset[] should be
+			   either -1, or the ID of a coiled coil X whose coiled_coil_subset[X] = -1.
+			   Likewise any daisy chains whose coiled coil ID (daisy_chain_cc)
+			   is currently set to i are moved.
+			   As always, these are moved to the coiled coil given by the first
+			   superset, and coiled coil i itself is assigned to that given by
+			   the last */
+			k = (coiled_coil_subset[first] == -1) ? first : coiled_coil_subset[first];
+			move_subsets(i,k);
+
+			k = (coiled_coil_subset[last] == -1) ? last : coiled_coil_subset[last];
+			coiled_coil_subset[i] = k;
+			subset_next[i] = subset_first[k];
+			subset_first[k] = i;
 			}
 
 		printf("coiled coil %2d: %2d helices ",i,coiled_coil_helices[i]);
@@ -260,14 +349,14 @@ int determine_order(/*int residue_index*/)
 		{
 		helix_order[i] = 0;
 
-		for (j = 0; j < coiled_coils; j++)
-			if (coiled_coil_subset[j] == -1)
-				{
-				k = 0; while ((k < coiled_coil_helices[j]) && (coiled_coil[j][k] != i)) k++;
-
-				if ((k < coiled_coil_helices[j]) && (coiled_coil_helices[j] > helix_order[i]))
-					helix_order[i] = coiled_coil_helices[j];
-				}
+		for (k = 0; k < COILED_COIL_WORDS; k++)
+			for (word = helix_coiled_coils[i][k], m = 0; word; word >>= 1, m++)
+				if (word & 1)
+					{
+					j = 32 * k + m;
+					if ((coiled_coil_subset[j] == -1) && (coiled_coil_helices[j] > helix_order[i]))
+						helix_order[i] = coiled_coil_helices[j];
+					}
 
 		if (helix_order[i] != 0) printf("helix %d is in a %d-stranded coiled coil\n",i,helix_order[i]);
 		}
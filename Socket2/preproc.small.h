@@ -99,18 +99,19 @@ the PDB file.
 					complementary knobs are stored for each
 					knob */
 
-#define MAX_PAIRS 60			/* the maximum number of pairs of
-					adjacent helices which pack with knobs-
-					into-holes; all such pairs are assessed
-					and then boiled down into assemblies
-					of N helices, where N is the order of
-					the coiled coil */
-
-#define MAX_DAISY_CHAINS 50		/* a 'daisy-chain' is an arrangement of
+#define MAX_CONTACTS 10			/* the maximum number of contacts which
+					can be stored for a residue; any more
+					are ignored (more than 5 means the
+					packing-cutoff is almost certainly too
+					high anyway) */
+
+#define MAX_DAISY_CHAINS 500		/* a 'daisy-chain' is an arrangement of
 					N cyclic-complementary knobs, ie one
 					knob per helix, where N > 2, forming a
 					layer perpendicular to the coiled-coil
-					axis */
+					axis; at high packing-cutoffs there can
+					be many (some 1500 among 4 hexamers at
+					12 Angstroms) */
 
 #define MAX_DAISIES 40			/* the maximum number of daisies (knobs)
 					in a daisy-chain (see above); the most
@@ -123,6 +124,17 @@ the PDB file.
 					surface, is close to 90 (tetramer) and
 					108 (pentamer) but not 120 (hexamer) */
 
+#define MAX_KNOB_LINKS 4000		/* the maximum number of links in the
+					knob-into-hole graph (see global.h,
+					knob_link[]); each knob is linked to
+					at most the knobs on the two sides of
+					its hole, so 4 per knob is generous */
+
+#define DAISY_HASH_SIZE 1024		/* the size of the hash set used to
+					discard duplicate daisy chains; must be
+					a power of 2, and at least twice
+					MAX_DAISY_CHAINS */
+
 #define MAX_COILED_COILS 50		/* the maximum number of coiled coils;
 					this however is not simply the number of
 					'true' coiled coils, but also the
@@ -130,26 +142,23 @@ the PDB file.
 					(which are identified first); sub-
 					assemblies which are wholly part of
 					larger assemblies are subsequently
-					ignored N.B. this number really ought
-					to be at least as large as MAX_PAIRS,
-					but currently is not */
+					ignored */
+
+#define COILED_COIL_HASH_SIZE 128	/* the size of the hash set used to
+					look up combinations of helices in the
+					list of coiled coils; must be a power
+					of 2, and at least twice
+					MAX_COILED_COILS */
+
+#define MAX_REGISTERS 20000		/* the maximum number of heptad register
+					assignments, i.e. of residues in the
+					helices of each coiled coil, summed
+					over the coiled coils; a residue in 2
+					coiled coils counts twice */
 
 #define MAX_HELICES_PER_COIL 40		/* is effectively the same as
 					MAX_DAISIES */
 
-#define MAX_DUPLICATES 20		/* it is possible for a large sidechain
-					to fit into more than one hole of 4
-					sidechains, if the packing-cutoff is on
-					the high side (the default of 7.0 is
-					quite liberal); almost certainly the
-					2 holes would each be on a different
-					helix, and such arrangements are not
-					part of classic coiled coil architecture
-					(and are also very rare);
-					this constant is the maximum number of
-					residues which are 'duplicate' knobs
-					*/
-
 #define MAX_SEQCHAINS 63		/* the maximum number of PDB chains
 					which can be handled; it is 63 because
 					its the alphabet in both cases, plus
@@ -163,6 +172,30 @@ the PDB file.
 					as well as upper */
 
 
+#define MAX_THREADS 16			/* the maximum number of threads which
+					can be asked for with -j */
+
+#define MAX_WORKERS 256			/* the maximum number of worker processes
+					which can be asked for with --workers,
+					when serving (--serve; see serve.c) */
+
+#define MAX_REQUEST_ARGS 64		/* the most arguments in a request to
+					the daemon (--serve) */
+
+#define MAX_REQUEST_LENGTH 4096		/* the longest line of arguments in a
+					request to the daemon, in characters */
+
+#define MAX_REQUEST_FILE (4L * 81 * MAX_ATOMS)	/* the largest PDB or DSSP
+					file a request to the daemon may send,
+					in bytes: four 81-character lines for
+					each atom, for the atoms outside helices
+					and the other records */
+
+#define REQUEST_TIMEOUT 30		/* the seconds the daemon allows a caller
+					to send its whole request, and to take
+					each part of the answer */
+
+
 /* the next 4 constants represent miscellaneous features */
 
 #define RASMOL_COLOURS 8		/* if a RasMol script is written, each
@@ -272,11 +305,11 @@ heterogens can be flagged */
 					ought to be specified in that header
 					file, instead of here */
 
-#define FLAGS 9				/* the number of available 'flags' i.e.
+#define FLAGS 15			/* the number of available 'flags' i.e.
 					binary command-line arguments, specified
 					by '-<flagName>' */
 
-#define PARS 11				/* the number of 'parameters', i.e.
+#define PARS 17				/* the number of 'parameters', i.e.
 					command-line arguments coupled with
 					values, specified by
 					'-<parameterName> <parameterValue>' */
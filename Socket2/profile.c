@@ -0,0 +1,254 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					profile.c
+
+
+Description: this C program identifies coiled-coil motifs in a Protein Data Bank
+(Berman et al, Nucleic Acids Res v28 pp235-42, 2000) file. Also required as
+input is a DSSP (Kabsch & Sander, Biopolymers v22 pp 2577-637) file derived from
+the PDB file.
+
+
+*/
+
+/*					profile.c
+					---------
+
+Where the time goes (-T). main() and find_knobs_and_holes() mark the stages of
+the analysis (enum stages, in global.h) with stage_begin() and stage_end(); the
+stages nest (e.g. check_complementarity() is called from within
+find_knobs_and_holes()), and the time of a stage excludes that of the stages
+within it, so the stage times add up to the total. Alongside, GLOBAL
+work_count[] counts the work done (enum counts): the helix pairs tested, the
+residue pairs measured, and so on; these are counted whether or not -T is set,
+as they cost next to nothing. With --trace, each stage is also written out as
+a span of the timeline (see trace.c).
+
+report_profile() writes it all as a single line, for batch runs to collect:
+
+	PROFILE <code> <stage>=<seconds> ... total=<seconds> <count>=<n> ...
+
+With --perf, the same stages are charged with the hardware performance
+counters of the process (Linux perf_event_open(): cycles, instructions, cache
+misses and branch misses, user space only, including any threads of -j), and
+report_counters() writes a line per stage, and one for the knobs-into-holes
+search per residue pair measured, which tells whether it is bound by memory or
+by arithmetic:
+
+	PERF <code> <stage> cycles=<n> instructions=<n> ipc=<x> cache_misses=<n> branch_misses=<n>
+	PERF <code> per_residue_pair residue_pairs=<n> cycles=<x> ... 
+
+A counter which cannot be opened (in many containers, or without a PMU, or
+with a high /proc/sys/kernel/perf_event_paranoid) is reported as '-', and if
+none can, that is said once and the analysis goes on regardless; elsewhere
+than Linux there are no counters at all.
+*/
+
+#include "socket.h"
+#include <stdlib.h>
+#include <time.h>
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+
+static char *stage_name[STAGES] = {"dssp","pdb","centres","ends","axes","contacts",
+	"knobs","complementarity","duplication","order","register","write"};
+
+static char *count_name[COUNTS] = {"helix_pairs","residue_pairs","contacts","knobs",
+	"daisy_steps","coiled_coils"};
+
+/* the seconds spent in each stage; the stages under way, innermost last, and
+the time at which the innermost was entered (or last resumed) */
+
+static double stage_time[STAGES], stage_since, stage_start[STAGES];
+static int stage_stack[STAGES], stage_depth = 0;
+
+/* the hardware counters (--perf): their file descriptors (-1 if unavailable),
+their totals for each stage, and their values when the innermost stage was
+entered (or last resumed) */
+
+enum counters {counter_cycles,counter_instructions,counter_cache_misses,
+	counter_branch_misses,COUNTERS};
+
+static char *counter_name[COUNTERS] = {"cycles","instructions","cache_misses",
+	"branch_misses"};
+
+static int counter_fd[COUNTERS] = {-1,-1,-1,-1}, counters_open = 0;
+static double counter_total[STAGES][COUNTERS], counter_since[COUNTERS];
+
+
+double monotonic_seconds()
+	{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC,&t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+	}
+
+
+void open_counters()
+	{
+#ifdef __linux__
+	struct perf_event_attr attr;
+	static unsigned long long config[COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_INSTRUCTIONS,PERF_COUNT_HW_CACHE_MISSES,PERF_COUNT_HW_BRANCH_MISSES};
+	int i,error = 0;
+
+	for (i = 0; i < COUNTERS; i++)
+		{
+		memset(&attr,0,sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config[i];
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.inherit = 1;	/* count the threads of -j too */
+		counter_fd[i] = syscall(SYS_perf_event_open,&attr,0,-1,-1,0);
+		if (counter_fd[i] == -1) error = errno;
+		else counters_open++;
+		}
+	if (!counters_open)
+		printf("PERF %s hardware counters unavailable (%s)\n",code,strerror(error));
+#else
+	printf("PERF %s hardware counters unavailable (not Linux)\n",code);
+#endif
+	}
+
+
+/* the counters now, scaled up if the kernel has had to share them out with
+other counters; 0 if unavailable */
+
+static void read_counters(double value[])
+	{
+	int i;
+#ifdef __linux__
+	unsigned long long v[3];
+#endif
+
+	for (i = 0; i < COUNTERS; i++)
+		{
+		value[i] = 0.0;
+#ifdef __linux__
+		if ((counter_fd[i] != -1) && (read(counter_fd[i],v,sizeof(v)) == sizeof(v)) && v[2])
+			value[i] = (double) v[0] * ((double) v[1] / v[2]);
+#endif
+		}
+	}
+
+
+/* charges the time and counters since the last change of stage to the
+innermost stage under way, if any */
+
+static void stage_charge(double t)
+	{
+	double value[COUNTERS];
+	int i;
+
+	if (counters_open) read_counters(value);
+	if (stage_depth)
+		{
+		stage_time[stage_stack[stage_depth-1]] += t - stage_since;
+		if (counters_open)
+			for (i = 0; i < COUNTERS; i++)
+				counter_total[stage_stack[stage_depth-1]][i] += value[i] - counter_since[i];
+		}
+	stage_since = t;
+	if (counters_open)
+		for (i = 0; i < COUNTERS; i++) counter_since[i] = value[i];
+	}
+
+
+void stage_begin(int stage)
+	{
+	double t;
+
+	if (!setflag[flag_T] && !setflag[flag_perf] && !tracing) return;
+	t = monotonic_seconds();
+	stage_charge(t);
+	stage_start[stage_depth] = t;
+	stage_stack[stage_depth++] = stage;
+	}
+
+void stage_end(int stage)
+	{
+	double t;
+
+	if (!setflag[flag_T] && !setflag[flag_perf] && !tracing) return;
+	if ((stage_depth == 0) || (stage_stack[stage_depth-1] != stage))
+		{
+		printf("stage_end: stage %s is not the one under way\n",stage_name[stage]);
+		exit(1);
+		}
+	t = monotonic_seconds();
+	stage_charge(t);
+	stage_depth--;
+
+	/* with --trace, the stage is also a span of the timeline, which takes
+	in the stages within it; the contact search is a stage of its own for
+	each helix pair, which is a span already (see trace_helix_pair()) */
+	if (tracing && (stage != stage_contacts))
+		trace_span(stage_name[stage],"stage",0,stage_start[stage_depth],NULL);
+	}
+
+
+void report_profile()
+	{
+	int i;
+	double total;
+
+	if (!setflag[flag_T]) return;
+
+	total = 0.0;
+	printf("PROFILE %s",code);
+	for (i = 0; i < STAGES; i++)
+		{
+		printf(" %s=%.6f",stage_name[i],stage_time[i]);
+		total += stage_time[i];
+		}
+	printf(" total=%.6f",total);
+	for (i = 0; i < COUNTS; i++) printf(" %s=%ld",count_name[i],work_count[i]);
+	printf("\n");
+	}
+
+
+void report_counters()
+	{
+	int i,s;
+	double pairs;
+
+	if (!setflag[flag_perf] || !counters_open) return;
+
+	for (s = 0; s < STAGES; s++)
+		{
+		printf("PERF %s %s",code,stage_name[s]);
+		for (i = 0; i < COUNTERS; i++)
+			{
+			if (counter_fd[i] == -1) printf(" %s=-",counter_name[i]);
+			else printf(" %s=%.0f",counter_name[i],counter_total[s][i]);
+			if (i == counter_instructions)
+				{
+				if ((counter_fd[counter_cycles] == -1) || (counter_fd[i] == -1) ||
+					(counter_total[s][counter_cycles] <= 0.0)) printf(" ipc=-");
+				else printf(" ipc=%.2f",counter_total[s][i] / counter_total[s][counter_cycles]);
+				}
+			}
+		printf("\n");
+		}
+
+	/* the residue pairs are all measured in the contacts stage (see
+	measure_residue_pair()) */
+	pairs = work_count[count_residue_pairs];
+	printf("PERF %s per_residue_pair residue_pairs=%ld",code,work_count[count_residue_pairs]);
+	for (i = 0; i < COUNTERS; i++)
+		if ((counter_fd[i] == -1) || (pairs <= 0.0)) printf(" %s=-",counter_name[i]);
+		else printf(" %s=%.2f",counter_name[i],counter_total[stage_contacts][i] / pairs);
+	printf("\n");
+	}
@@ -55,9 +55,20 @@ int set_flagsNpars(int argc, char *argv[]);
 	(atom_index atoms have been read by read_helical_pdb() ),and the
 	coordinates of the appropriate atoms for each residue are used to
 	calculate the mean coordinates of the side chain, i.e. the values of
-	GLOBAL refatoms2; which atoms are used is determined by -a and -i */
+	GLOBAL refatoms2; which atoms are used is determined by -a and -i,
+	and by the class of each atom (GLOBAL atom_class); if -m is set, the
+	atoms have not been kept, and the sums gathered by stream_atom() for
+	each of the residue_index residues are divided instead */
 
-void determine_centre_of_mass(int atom_index);
+void determine_centre_of_mass(int residue_index, int atom_index);
+
+
+/* stream_atom: with -m, is given each atom (of class class, see enum
+	atom_class) as it is read by read_helical_pdb(), instead of its being
+	stored; adds it to the sum for the side chain centre of residue,
+	and keeps it if it is one of the reference atoms of residue */
+
+void stream_atom(int atom, int residue, int class, float x, float y, float z);
 
 
 /* determine_end: processes the list of alpha-helix residues (there are
@@ -68,12 +79,30 @@ void determine_centre_of_mass(int atom_index);
 
 void determine_end(int residue_index, int atom_index);
 
+/* index_helix_residues: lists the residue-keys of each helix, in compressed
+	sparse row form (GLOBAL helix_residue_start[], helix_residue[]), so that
+	the residues of a helix are found without searching every residue */
+
+void index_helix_residues(int residue_index);
+
+/* determine_helix_axes: finds the residue-keys of the terminal residues of each
+	helix (GLOBAL helix_N_residue[] and helix_C_residue[]), and a unit
+	vector along each helix axis (GLOBAL helix_axis[]); the axis is the line
+	from the alpha-carbon of the N-terminal residue to that of the
+	C-terminal residue, or, if -x is set, the principal axis of the
+	mid-points of each 4 consecutive alpha-carbons; done once, after the
+	PDB file is read, so that the orientation of any pair of helices is
+	just a dot product */
+
+void determine_helix_axes(int residue_index);
+
 
 /* measure_helix_pair: applies measure_residue_pair() to all combinations of
 	residues R1, R2 where R1 is on helix1 and R2 is on helix2; helix1 and
-	helix2 are helix-keys */
+	helix2 are helix-keys; the residues of each helix are listed in GLOBAL
+	helix_residue[] (see index_helix_residues()) */
 
-void measure_helix_pair(int helix1, int helix2, int residue_index);
+void measure_helix_pair(int helix1, int helix2);
 
 
 /* measure_residue_pair: measures three distances between pairs of atoms in
@@ -128,8 +157,9 @@ float measure_centre_distance(int res1, int res2);
 
 
 /* measure_k_end_h_CA: returns the mean distance between the end (GLOBAL
-	refatom1B) of a knob (identified by knob-key knobid) side chain and each
-	of the 4 alpha-carbons (GLOBAL refatom0) of the residues forming the
+	residue_geometry[].end) of a knob (identified by knob-key knobid) side
+	chain and each of the 4 alpha-carbons (GLOBAL residue_geometry[].ca) of
+	the residues forming the
 	hole into which it fits; this is how types 1 and 3 ('knobs across
 	holes') are distinguished from types 2 and 4 ('knobs-into-holes'); the
 	latter have the result less than or equal to the insertion-cutoff (set
@@ -138,6 +168,17 @@ float measure_centre_distance(int res1, int res2);
 float measure_k_end_h_CA(int knobid);
 
 
+/* measure_knob: fills in the geometry record (GLOBAL knob_geometry[]) of the
+	knob with knob-key knobid, whose residue and hole have just been found:
+	the distances of the knob from its hole residues, the lengths of the
+	hole's four sides, the mean distance of the knob end from the hole's
+	alpha-carbons (see measure_k_end_h_CA()) and the packing angle (see
+	packing_angle()); nothing is measured again, to classify the knob or to
+	write it out */
+
+void measure_knob(int knobid);
+
+
 /* distance: returns the distance between two coordinates, each represented as
 	a 3-element float array; used by the measure_*_diatance() functions
 	described above */
@@ -148,35 +189,29 @@ float distance(float coords1[], float coords2[]);
 /* check_complementarity: after all the knobs fitting into holes have been
 	identified (the knobs will have been assigned either type 1 or 2),
 	all the knobs (the total number of knobs is held in GLOBAL knob_index)
-	are checked against one another for complementarity, using functions
-	complementary() to identify pairwise-, and then check_daisy_chain() to
-	identify cyclic-complementarity; complementary knobs have their (GLOBAL)
-	knobtype increased to 3 or 4 (or even 5 or 6; see n_knobtype[] array),
-	and the complementary knob(s) (if any) of each knob are stored in
-	compknob[] array. ** N.B. refer to check_daisy_chain() **
-	The call to check_daisy_chain() specifies an order of 0, and a
-	1-dimensional array, which is a single element of the 2-dimensional
-	GLOBAL array daisy_chain[][], is passed to check_daisy_chain(); the
-	1-dimensional array local to check_daisy_chain() is also called
-	daisy_chain[] (but its 1-DIMENSIONAL!). The GLOBAL daisy_chain[][]
-	array is simply a list (indexed by the first []) of daisy chains. The
-	element passed is simply the next empty daisy chain in the list. The
-	number of daisy chains is held by the GLOBAL daisy_chains, and the
-	current value of daisy_chains represents the next (empty) slot. So the
-	call from check_complementarity() always passes
-	daisy_chain[daisy_chains] to check_daisy_chain(). If the result is
-	negative (-1 or -2 returned), then the components (if any) of the failed
-	chain are effectively wiped from daisy_chain[daisy_chains] (because the
-	next call to check_daisy_chain() will re-use this slot); otherwise, the
-	newly found daisy-chain is checked to see if its the same as any
-	previously found daisy chains (earlier in the GLOBAL daisy_chain[][]
-	list), but with the knobs simply listed in a different order; if it is
-	indeed the same, then daisy_chain[daisy_chains] is wiped. Otherwise, it
-	is a genuinely new daisy chain, and so daisy_chains is incremented. This
-	continues until all knobs have been used as the argument for a call to
-	check_daisy_chain() from check_complementarity(). */
-
-void check_complementarity();
+	are checked against one another for complementarity; index_knobs() is
+	called first, so that complementary() can identify pairwise-
+	complementary knobs without searching the whole list of knobs; then
+	build_knob_graph() and find_daisy_chains() identify cyclic-
+	complementarity, i.e. fill the GLOBAL daisy_chain[][] list (see
+	daisies.c); complementary knobs have their (GLOBAL) knob[].type increased
+	to 3 or 4 (or even 5 or 6; see n_knobtype[] array), and the
+	complementary knob(s) (if any) of each knob are stored in its
+	compknob[] array. Each knob's order is 2 if it is pairwise complementary, or
+	the size of the largest daisy chain of which it is part, if larger */
+
+void check_complementarity(int residue_index);
+
+
+/* index_knobs: fills the GLOBAL residue_knob_start[] and residue_knob[]
+	arrays, which list the knobs at each residue (there are residue_index
+	helical residues); this makes it possible to go from a hole residue to
+	the knob(s) at that residue, if any, directly; and likewise
+	helix_knob_start[] and helix_knob[], which list the knobs on each
+	helix, so that find_register() only looks at the knobs of the helices
+	of each coiled coil */
+
+void index_knobs(int residue_index);
 
 
 /* check_duplication: it is possible, but rare, for a long side chain to make
@@ -188,7 +223,9 @@ void check_complementarity();
 	ILE 635:C, TYR 638:C, THR 639:C, ILE 642:C);
 	565:N will have been recorded as two different knobs, and this function
 	detects such instances (not much is done with them, but it is useful to
-	tell the user what they are) */
+	tell the user what they are); the sets are the residues with more
+	than one knob in the index made by index_knobs() (GLOBAL
+	duplicate_residue[]), so there is no limit on their number or size */
 
 void check_duplication();
 
@@ -224,19 +261,27 @@ float packing_angle(int knobres, int holeres1, int holeres2);
 void add_contact(int res1, int res2, float distance);
 
 
-/* report_kih: after all the contacts have been assigned, the cases of residues
-	with 4 or more contacts are assigned as knobs; each is assigned the
-	knob-type 1 or 2, as determined by measure_k_end_h_CA(); the knob
-	residues are put into the array knob[], the residues of their
-	corresponding holes are put in hole[] and the number of knobs is
-	stored in GLOBAL knob_index */
+/* report_kih: after all the contacts between the current pair of helices have
+	been assigned, the cases of residues with 4 or more contacts are
+	assigned as knobs; each is assigned the knob-type 1 or 2, as determined
+	by measure_k_end_h_CA(); each knob residue, and the residues of its
+	corresponding hole, are put into a new record of the array knob[],
+	and the number of knobs is stored in GLOBAL knob_index */
+
+void report_kih();
 
-void report_kih(int residue_index);
 
+/* list_pair_residues: makes helix1 and helix2 the current pair of helices,
+	whose residues are those reset by reset_contacts() and read by
+	best_kih() and report_kih() */
 
-/* reset_contacts: initializes number of contacts of each residue
-	(n_contacts[], indexed by residue-key) to zero; is called only once;
-	should probably be done in function initialize() */
+void list_pair_residues(int helix1, int helix2);
+
+
+/* reset_contacts: initializes number of contacts of each residue of the
+	current pair of helices (n_contacts[], indexed by residue-key) to zero;
+	called before the contacts of each pair of helices are measured (only
+	the residues of the pair are read by best_kih() and report_kih()) */
 
 void reset_contacts();
 
@@ -250,9 +295,19 @@ void reset_contacts();
 	group will occupy the first 4 elements. This is because later functions
 	which test the hole spacing pattern assume that there is an x,1,y
 	spacing pattern (anything but the first 4 elements are ignored); groups
-	which do not match this will be discarded */
+	which do not match this will be discarded; only the residues of the
+	current pair of helices are checked */
+
+void best_kih();
 
-void best_kih(int residue_index);
+
+/* legacy_contacts, legacy_best_kih: the legacy engines (--legacy) for
+	reset_contacts() with measure_helix_pair(), and for best_kih(), which
+	scan all the residues; the results must be the same (see legacy.c) */
+
+void legacy_contacts(int helix1, int helix2, int residue_index);
+
+void legacy_best_kih(int residue_index);
 
 
 /* write_files: creates the 'long' and 'data' output files, specified by -o and
@@ -261,6 +316,101 @@ void best_kih(int residue_index);
 void write_files(int residue_index);
 
 
+/* write_json: writes the helices, residues and their registers, knobs, daisy
+	chains and true coiled coils to the JSON file (-J, file handle
+	json_file), from what is held in memory once find_register() has been
+	called; see json.c for the layout */
+
+void write_json(int residue_index);
+
+
+/* write_knob_columns: appends one row per knob to the column files (one file
+	per field, fixed-width and little-endian) in directory dir (-K), which
+	is created, with a SCHEMA describing the columns, if need be; see
+	knobcols.c for the layout */
+
+void write_knob_columns(char dir[]);
+
+
+/* stage_begin, stage_end: mark the beginning and end of a stage of the analysis
+	(enum stages), whose time is reported by -T; stages can be nested, in
+	which case the time of the inner stage is not counted in that of the
+	outer; stage_end() must be given the innermost stage under way. Neither
+	does anything unless -T or --trace is set (see profile.c); with --trace,
+	stage_end() also writes the stage to the trace */
+
+void stage_begin(int stage);
+
+void stage_end(int stage);
+
+
+/* report_profile: writes the time spent in each stage, and the counts of work
+	done (GLOBAL work_count[]), on one line beginning PROFILE; only if -T is
+	set */
+
+void report_profile();
+
+
+/* open_counters: opens the hardware performance counters (--perf) with
+	perf_event_open(), on Linux; those which cannot be opened are left out,
+	and if none can, that is said once (see profile.c) */
+
+void open_counters();
+
+
+/* report_counters: writes the counters of each stage, with the instructions
+	per cycle, and of the knobs-into-holes search per residue pair measured,
+	on lines beginning PERF; only if --perf is set and a counter opened */
+
+void report_counters();
+
+
+/* report_memory: writes the bytes used against the bytes reserved for each
+	major structure, and the peak resident set size, on lines beginning
+	MEMORY; only if --mem-report is set (see memory.c) */
+
+void report_memory(int residue_index, int atom_index);
+
+
+/* monotonic_seconds: the time in seconds from an arbitrary start, which never
+	goes backwards; for timing stages and trace spans */
+
+double monotonic_seconds();
+
+
+/* open_trace: opens the trace file (--trace), reads --trace-min and sets
+	GLOBAL tracing; the trace's clock starts here */
+
+void open_trace(char file_name[]);
+
+
+/* trace_span: writes a span of the timeline, from start (see
+	monotonic_seconds()) until now, on thread (0 for the main thread), with
+	args (a JSON object, or NULL); may be called from any thread */
+
+void trace_span(char name[], char category[], int thread, double start, char args[]);
+
+
+/* trace_helix_pair: writes the knobs-into-holes search of helices helix1 and
+	helix2, begun at start, if it took at least --trace-min microseconds */
+
+void trace_helix_pair(int helix1, int helix2, double start, long residue_pairs);
+
+
+/* close_trace: writes the span of the whole run and the names of the threads,
+	and closes the trace file (see trace.c) */
+
+void close_trace();
+
+
+/* serve: runs as a daemon on the Unix domain socket socket_name (--serve),
+	with a pool of --workers worker processes, each forked from the
+	initialized program, which analyse one request each and answer it with
+	a JSON document; never returns (see serve.c) */
+
+void serve(char socket_name[]);
+
+
 /* find_register: the longest and most complicated function, which assesses each
 	true coiled coil (see determine_order() ) and assigns to it not only
 	the register of each residue within knobs-into-holes packing regions,
@@ -306,39 +456,73 @@ void write_files(int residue_index);
 	If a RasMol script has been requested, set-definitions of the true
 	coiled coils are written to it, along with the lists of residues which
 	have each of the 7 registers.
+
+	With -j, the coiled coils are shared between that many threads: those
+	which share a helix (and so helix-pair orientations) are assigned their
+	registers by the same thread, in order; each thread's output is gathered
+	and written out in order of coiled coil, after all are done.
 	*/
 
-int find_register(int residue_index);
+int find_register();
+
+
+/* new_registers: makes room for the heptad registers of the residues of each
+	helix of coiled coil c, all set to ' ' (no register); the registers are
+	only stored for these residues */
+
+void new_registers(int c);
+
+
+/* get_register: the heptad register ('a'..'g', or ' ' if none) of residue r
+	(a residue-key) in coiled coil c; ' ' also if r is not in a helix of c,
+	and '\0' if c has not been through new_registers() */
+
+char get_register(int r, int c);
+
+
+/* set_register: sets the heptad register of residue r in coiled coil c to reg;
+	r must be in one of the helices of c */
+
+void set_register(int r, int c, char reg);
+
+
+/* index_registers: lists, for each residue, the coiled coils in which it has a
+	register (GLOBAL residue_register_start[] and residue_register_cc[]),
+	so that the registers of a residue can be written out without looking
+	at every coiled coil */
+
+void index_registers();
+
+
+/* register_footprint: the bytes of register storage in use, and reserved, for
+	--mem-report */
+
+void register_footprint(long *used, long *reserved);
 
 
 /* terminal_orientation: this returns the relative orientation (0 for parallel,
 	1 for antiparallel) of the two helices whose helix-keys are helix1 and
-	helix2. Each helix is represented by a fairly crude axis, from the
-	reference atom type (0) (i.e. alpha-carbon) of the N-terminal residue to
-	the equivalent of the C-terminal residue. The interhelical angle is
-	therefore       _ _     _  _                   _     _
-		arccos( a.b / (|a||b|) ) where vectors a and b represent the
-	two helix axes. Called by find_register() */
-
-int terminal_orientation(int helix1, int helix2, int residue_index);
-
-
-/* orientation_of_helices: LOCAL to find_register(), a table of relative helix
-	orientations is stored in the arrays orientation_first_helix[],
-	orientation_second_helix[] and orientation[]. The number of rows in the
-	table is stored in variable pairs, also LOCAL. The values in the first
-	two are helix-keys, while the values in the second are 0 and 1. The
-	relative orientation of two helices might be referred to several times,
-	for example if they belong to complex assemblies in which they
-	effectively belong to more than one coiled coil simultaneously.
-	Therefore they are determined once and then stored in the table. This
-	function simply retrieves the relative orientation from this table (the
-	3 arrays are passed to it, along with the helix-keys of the two helices
-	queried); called by find_register() */ 
-
-int orientation_of_helices(int helix1, int helix2,
-	int orientation[], int orientation_first_helix[],
-	int orientation_second_helix[], int pairs);
+	helix2. Each helix is represented by its unit axis, helix_axis[] (see
+	determine_helix_axes()). The interhelical angle is therefore
+	 _ _     _    _
+	arccos( a.b ) where the unit vectors a and b represent the two helix
+	axes; the angle is reported to out. Called by find_register() */
+
+int terminal_orientation(int helix1, int helix2, FILE *out);
+
+
+/* orientation_of_helices: a table of relative helix orientations is stored
+	in the GLOBAL array helix_pair_orientation[][], indexed by the
+	helix-keys of the two helices; the values are 0 and 1, or -1 if the
+	orientation has not been determined. The relative orientation of two
+	helices might be referred to several times, for example if they belong
+	to complex assemblies in which they effectively belong to more than one
+	coiled coil simultaneously. Therefore they are determined once and then
+	stored in the table. This function simply retrieves the relative
+	orientation from this table (given the helix-keys of the two helices
+	queried, in either order); called by find_register() */ 
+
+int orientation_of_helices(int helix1, int helix2);
 
 /* set_orientation_of_helices: this function resets the relative orientation of
 	helices identified by helix-keys helix1 and helix2 in the table (see
@@ -347,9 +531,7 @@ int orientation_of_helices(int helix1, int helix2,
 	disagrees with the result from terminal_orientation() (above); refer to
 	find_register(), which calls it */
 
-void set_orientation_of_helices(int helix1, int helix2, int new_orientation,
-	int orientation[], int orientation_first_helix[],
-	int orientation_second_helix[], int pairs);
+void set_orientation_of_helices(int helix1, int helix2, int new_orientation);
 
 
 /* check_extremes_of_hole: given the knob-key of a knob, each of the four
@@ -360,7 +542,7 @@ void set_orientation_of_helices(int helix1, int helix2, int new_orientation,
 	then one (or both) of these arrays is updated appropriately;
 	called by find_register() */
 
-void check_extremes_of_hole(int knob, int c);
+void check_extremes_of_hole(int knobid, int c);
 
 
 /* relative_register: returns the appropriate register (as a char), given a
@@ -370,50 +552,30 @@ void check_extremes_of_hole(int knob, int c);
 char relative_register(char reg, int offset);
 
 
-/* check_daisy_chain: this is called by check_complementarity(), and by itself.
-	Its purpose is to check a knob to test whether it is in a 'daisy-chain',
-	i.e. a cyclic arrangment of knobs-into-holes (the hallmark of coiled
-	coils with > 2 strands).
-	It works by checking EITHER of the two residues (which, is determined by
-	the variable direction, which is either 1 or -1) which form the sides of
-	the hole into which the query knob (identified by knob-key thisknob)
-	fits, to see if the hole residue is itself a knob; if it is, then the
-	function calls itself with this latter knob as the argument. Each
-	recursive call lengthens a chain of complementarity by one residue; the
-	length of this chain is stored in the variable order, so-called because,
-	if indeed the chain is found to form a closed loop, then the length of
-	the loop is the order of the coiled coil.
-	The components of the lengthening chain are stored in the 1-dimensional
-	array daisy_chain, whose elements are the knob-keys of the knobs in the
-	chain. A chain is found to be closed if one of the two residues, which
-	form the sides of the hole into which knob identified by knob-key
-	thisknob fits, is the original knob, i.e. the FIRST one in the
-	daisy_chain[] array (it does not matter which of the two sides is the
-	knob, just as long as one of them is; i.e. direction is not relevant
-	here).
-	If all the knobs in the list (there are GLOBAL knob_index knobs) are
-	checked, and the chain does not close, then the function returns a value
-	of -1.
-	** N.B. in complex arrangements, it is possible for a chain to close
-	itself, but not head-to-tail; i.e. the first knob is at the end of a
-	linear chain which feeds into a cyclic arrangement. If this happens,
-	then the function returns -2.
-	** N.B. if a chains which close themselves immediately are ignored; that
-	is if the closed chain has a length of 2, it is a pairwise-complementary
-	interaction. Pairwise-complementarity is checked separately, before
-	cyclic-complementarity. It would be neater to check them all at once,
-	but checks for daisy chains were implemented much later than the
-	pairwise-check. But it could probably do with being tidied up to this
-	end, though its unlikely it would make the algorithm significantly
-	faster.
-	** N.B. the first call of check_daisy_chain() is from
-	check_complementarity(); this call specifies an order of 0, and the
-	1-dimensional array, used as the daisy_chain[] array locally by
-	check_daisy_chain(), IS A SINGLE ELEMENT OF A GLOBAL 2-DIMENSIONAL ARRAY
-	- WHICH IS ALSO CALLED 'daisy_chain' - SORRY. See
-	check_complementarity()	*/
-
-int check_daisy_chain(int thisknob, int order, int daisy_chain[], int direction);
+/* build_knob_graph: called by check_complementarity(), after
+	index_knobs(); fills the GLOBAL knob_link_start[] and knob_link[]
+	arrays, the directed graph in which each knob is linked to the knob(s)
+	forming either of the two sides of its hole, provided that the latter's
+	hole is not in the former's helix (which would simply be a pairwise-
+	complementary interaction) */
+
+void build_knob_graph();
+
+
+/* find_daisy_chains: this is called by check_complementarity(), after
+	build_knob_graph(). Its purpose is to find all the 'daisy-chains',
+	i.e. cyclic arrangements of knobs-into-holes (the hallmark of coiled
+	coils with > 2 strands); these are the elementary cycles (of at most
+	MAX_DAISIES knobs) of the knob-into-hole graph. The graph is split into
+	strongly connected components, and each cycle is traced once only,
+	from its lowest-numbered knob, within that knob's component (see
+	daisies.c for details). Each daisy chain is stored in the GLOBAL
+	daisy_chain[][] list as its knob-keys in ascending order; cycles which
+	are a different ordering of the same knobs are discarded, with the aid
+	of a hash set. The GLOBAL daisy_chains, the number of daisy chains
+	found, is returned */
+
+int find_daisy_chains();
 
 
 /* determine_order: this function uses the lists of complementary knobs
@@ -462,14 +624,28 @@ void dumpknobs(int aknob);
 
 /* initialize: this function is called once by main(), which passes argc and
 	argv to it; initialize() calls set_flagsNpars(argc,argv) to convert the
-	command-line arguments into the correct values of par and setflag;
-	initialize() reads int and float variables from some of the par strings,
-	otherwise these variables are set to their default values. The various
-	GLOBAL arrays are set to null values */
+	command-line arguments into the correct values of par and setflag, and
+	read_parameters() to read them. The various GLOBAL arrays are set to
+	null values */
 	
 void initialize(int argc, char *argv[]);
 
 
+/* read_parameters: reads int and float variables from some of the par strings,
+	otherwise these variables are set to their default values; called by
+	initialize(), and by each worker of the daemon (see serve.c) for the
+	arguments of its request */
+
+void read_parameters();
+
+
+/* analyse_structure: the whole analysis of the structure in the files opened by
+	check_files(), from reading the DSSP file to writing the results; called
+	once by main(), or by each worker of the daemon for its request */
+
+void analyse_structure();
+
+
 /* check_files: the files specified by the command line (-f and -s are
 	mandatory) are opened, and the program dies if any of them cannot be;
 	the 4-letter code (if there is one) in the PDB input file name (-f) is
@@ -540,13 +716,22 @@ void prune_extended_helices(int residue_index, int helix_index,
 	PDB 'chainID', and coordinates PDB 'x', 'y' and 'z', of each atom
 	belonging to an alpha-helix residue; these are respectively read into
 	GLOBALS atom_name, atom_no, coord[0..2], and the corresponding
-	residue-key (GLOBAL atom_res) is determined; the function returns the
-	total number of alpha-helix atoms read in; if there are any hydrogen
-	atoms, they are not read unless -a was specified */
+	residue-key (GLOBAL atom_res) is determined; the class of each atom
+	(GLOBAL atom_class) is found from its name once, as it is read, and
+	the reference atoms refatom0, refatom1 and refatom3 are set from it;
+	the function returns the total number of alpha-helix atoms read in; if
+	there are any hydrogen atoms, they are not read unless -a was
+	specified */
 
 int read_helical_pdb();
 
 
+/* atom_key: packs the 4-character atom name into a 32-bit key (see ATOM_KEY
+	in global.h), so that atom names are compared as integers */
+
+unsigned int atom_key(char name[]);
+
+
 /* find_knobs_and_holes: does what it says, firstly by calling
 	measure_helix_pair() for each unique combination of helices to find all
 	inter-helical residue-residue contacts; then adjusting any groups of > 4
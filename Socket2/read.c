@@ -78,6 +78,8 @@ int read_helical_dssp(int extend /*, int join*/)
 	residue_index = 0;
 	if (!extend) helix_index = 0;
 	is_helical = false;
+	/* no residue precedes the first (no chain identifier is '\0') */
+	lastchainID = '\0'; lastresidue = 0; lastiCode = ' ';
 
 /*for (i = 0; i < helix_index; i++)
 			printf("\thelix %d (%d-%d:%c)\n",i,helix_start[i],helix_end[i],helix_chain[i]);XXX*/
@@ -192,6 +194,19 @@ int read_helical_dssp(int extend /*, int join*/)
 	/* end of read_helical_dssp */
 	}
 
+void index_helix_residues(int residue_index)
+	{
+	int h,r;
+
+	/* a counting sort of the residue-keys by helix-key */
+	for (h = 0; h <= helix_index; h++) helix_residue_start[h] = 0;
+	for (r = 0; r < residue_index; r++) helix_residue_start[helix_no[r]+1]++;
+	for (h = 0; h < helix_index; h++) helix_residue_start[h+1] += helix_residue_start[h];
+	for (r = 0; r < residue_index; r++) helix_residue[helix_residue_start[helix_no[r]]++] = r;
+	for (h = helix_index; h > 0; h--) helix_residue_start[h] = helix_residue_start[h-1];
+	helix_residue_start[0] = 0;
+	}
+
 int within_helix(int resno, char iCode, char chain, int helix_start[], char helix_start_iCode[],
 	int helix_end[], char helix_end_iCode[], char helix_chain[], int n_helices)
 	{
@@ -414,6 +429,8 @@ void pre_parse_dssp(int *helix_index, int helix_start[], char helix_start_iCode[
 	all_index = 0;	/* the number of residues */
 	*helix_index = 0;
 	is_helical = false;
+	/* no residue precedes the first (no chain identifier is '\0') */
+	lastchainID = '\0'; lastresidue = 0; lastiCode = ' ';
 
 	while (fgets(textstring,18,dssp_file) != NULL)
 		{
@@ -683,10 +700,101 @@ void prune_extended_helices(int residue_index, int helix_index, int helix_start[
 		}
 	} /* end of prune_extended_helices */
 
+/* the classes of the atom names which are not side chain atoms (as far as the
+'centre of mass' is concerned); any other name is atom_side_chain */
+
+static const struct { unsigned int key; unsigned char class; } atom_class_table[] = {
+	{ATOM_KEY(" N  "), atom_backbone}, {ATOM_KEY(" C  "), atom_backbone},
+	{ATOM_KEY(" O  "), atom_backbone}, {ATOM_KEY(" CA "), atom_CA},
+	{ATOM_KEY(" HA "), atom_HA}, {ATOM_KEY("1HA "), atom_HA},
+	{ATOM_KEY("2HA "), atom_HA}, {ATOM_KEY(" CB "), atom_CB} };
+
+#define ATOM_CLASSES ((int) (sizeof(atom_class_table) / sizeof(atom_class_table[0])))
+
+
+unsigned int atom_key(char name[])
+	{
+	unsigned int key;
+	int i;
+
+	/* a name shorter than 4 characters is padded with zeros */
+	key = 0;
+	for (i = 0; i < 4; i++)
+		{
+		key <<= 8;
+		if (*name) key |= (unsigned char) *name++;
+		}
+	return key;
+	}
+
+
+/* returns the class of atom (an atom-key) of residue (a residue-key) of amino
+acid type aacode, and records it as a reference atom of the residue if it is one;
+the name is packed and compared once, here */
+
+static int classify_atom(int atom, int residue, int aacode, char name[])
+	{
+	unsigned int key;
+	int i, class;
+
+	key = atom_key(name);
+
+	class = atom_side_chain;
+	for (i = 0; i < ATOM_CLASSES; i++)
+		if (atom_class_table[i].key == key)
+			{
+			class = atom_class_table[i].class;
+			break;
+			}
+
+	if (key == refatom0key) refatom0[residue] = atom;
+	if (class == atom_CB) refatom3[residue] = atom;
+	if (key == refatomkey[0][aacode])
+		{
+		refatom1[0][residue] = atom;
+		class |= atom_end1;
+		}
+	else if (key == refatomkey[1][aacode])
+		{
+		refatom1[1][residue] = atom;
+		class |= atom_end2;
+		}
+
+	return class;
+	}
+
+
+/* keeps atom (an atom-key) of residue, in the GLOBAL atom arrays; or, if -m is
+set, passes it to stream_atom() (see geometry.c), and forgets it */
+
+static void store_atom(int atom, int residue, int class, int serial, char name[],
+	float x, float y, float z)
+	{
+	if (setflag[flag_m])
+		{
+		stream_atom(atom,residue,class,x,y,z);
+		return;
+		}
+
+	if (atom == MAX_ATOMS)
+		{
+		printf("Maximum no of atoms (%d) exceeded\n",MAX_ATOMS);
+		exit(1);
+		}
+	atom_no[atom] = serial;
+	strcpy(atom_name[atom],name);
+	atom_class[atom] = class;
+	atom_res[atom] = residue;
+	coord[atom][0] = x;
+	coord[atom][1] = y;
+	coord[atom][2] = z;
+	}
+
+
 int read_helical_pdb()
 	{
 	int lastresidue ,atom_index, last_residue_index, serial, resSeq,
-		residue_index, i,j, null_heterogen, mapped_residue_aacode;
+		residue_index, i,j, null_heterogen, mapped_residue_aacode, class;
 	char name[5] = "XXXX", resName[4] = "XXX", segID[5] = "XXXX",
 		stdRes[4] = "XXX", lastchain,chainID,altLoc,iCode,lastiCode,aacode;
 
@@ -898,8 +1006,10 @@ printf("heterogen3[0] = \"%s\"; *(heterogen3[0]) = \"%c\"\n",heterogen3[0],*(het
 				if (chainID == ' ') j = 0;
 				else if ((chainID >= 'A') && (chainID <= 'Z')) j = chainID - 'A' + 1;
 				else if ((chainID >= 'a') && (chainID <= 'z')) j = chainID - 'a' + 27;
-				else j = chainID - '0' + 53;
-				if (seqchain[j] == NULL_SEQCHAIN)	{
+				else if ((chainID >= '0') && (chainID <= '9')) j = chainID - '0' + 53;
+				else j = -1; /* any other chain identifier is not counted
+						in seqchain[] (see MAX_SEQCHAINS) */
+				if ((j >= 0) && (seqchain[j] == NULL_SEQCHAIN))	{
 				seqchain[j] = resSeq;
 				printf("chain %c starts at residue %4d, iCode='%c'\n",chainID,resSeq,iCode);
 				}
@@ -916,35 +1026,16 @@ printf("heterogen3[0] = \"%s\"; *(heterogen3[0]) = \"%c\"\n",heterogen3[0],*(het
 					an alpha-helix */
 
 				if (is_helical) {
-					if (atom_index == MAX_ATOMS)
-						{
-						printf("Maximum no of atoms (%d) exceeded\n",MAX_ATOMS);
-						exit(1);
-						}
-					if (strcmp(name,refatom0type) == 0) refatom0[last_residue_index] = atom_index;
-					if (strcmp(name,REFATOM3) == 0) refatom3[last_residue_index] = atom_index;
 					aacode = map_alpha3_to_amino_acid(resName);
-					for (j = 0; j < 2; j++)
-						if (strcmp(name,refatomtype[j][aacode]) == 0)
-							{
-							refatom1[j][last_residue_index] = atom_index;
-							break;
-							}
-					atom_no[atom_index] = serial;
-					strcpy(atom_name[atom_index],name);
-					atom_res[atom_index] = last_residue_index;
-					coord[atom_index][0] = x;
-					coord[atom_index][1] = y;
-					coord[atom_index++][2] = z;
+					class = classify_atom(atom_index,last_residue_index,aacode,name);
+					store_atom(atom_index++,last_residue_index,class,serial,name,x,y,z);
 					/*printf("%d,%d,%d,%s,%8.3f,%8.3f,%8.3f,%c,%4d\n",atom_index,last_residue_index,atom_no[atom_index-1],atom_name[atom_index-1],x,y,z, chainID,resSeq );*/
-					if ((strcmp(atom_name[atom_index-1]," CA ")==0)&&(strcmp(resName,"GLY"))==0)
+					if (((class & ATOM_CLASS_MASK) == atom_CA)&&(strcmp(resName,"GLY"))==0)
 					{
-						atom_no[atom_index]=serial-2;
-						strcpy(atom_name[atom_index],"CB");
-						atom_res[atom_index] = last_residue_index;
-						coord[atom_index][0] = x+1.126;
-						coord[atom_index][1] = y+0.872;
-						coord[atom_index++][2] = z+0.512;
+						/* named "CB", not " CB ", so this is counted
+						as a side chain atom but is not refatom3 */
+						store_atom(atom_index++,last_residue_index,atom_side_chain,serial-2,"CB",
+							x+1.126,y+0.872,z+0.512);
 						/*printf("%s,%s\n",atom_name[atom_index-1],resName);
 						printf("%d,%d,%d,%s,%8.3f,%8.3f,%8.3f,%c,%4d\n",atom_index,last_residue_index,atom_no[atom_index-1],atom_name[atom_index-1],x,y,z, chainID,resSeq );*/
 					}
@@ -1044,42 +1135,21 @@ XXX delete this crap*/
 							helix_residue_chain[residue_index++] = chainID; these already set by
 							read_helical_dssp*/
 
-							if (atom_index == MAX_ATOMS)
-								{
-								printf("Maximum no of atoms (%d) exceeded\n",MAX_ATOMS);
-								exit(1);
-								}
-
-							atom_no[atom_index] = serial;
-							strcpy(atom_name[atom_index],name);
-
 							for (last_residue_index = 0;
 								last_residue_index < residue_index; last_residue_index++)
 								if ((helix_residue_no[last_residue_index] == resSeq)
 									&& (helix_residue_iCode[last_residue_index] == iCode)
 									&& (helix_chain[helix_no[last_residue_index]] == chainID))
-									{
-									atom_res[atom_index] = last_residue_index;
 									break;
-									}
 								else if (last_residue_index == residue_index -1)
 									{
 									printf("oops- couldnt find this residue (resSeq=%d,chainID='%c') in the list read from the DSSP file\n",
 									resSeq,chainID);
 									exit(1);
 									}
-							if (strcmp(name,refatom0type) == 0) refatom0[last_residue_index] = atom_index;
-							if (strcmp(name,REFATOM3) == 0) refatom3[last_residue_index] = atom_index;
 							aacode = map_alpha3_to_amino_acid(resName);
-							for (j = 0; j < 2; j++)
-								if (strcmp(name,refatomtype[j][aacode]) == 0)
-									{
-									refatom1[j][last_residue_index] = atom_index;
-									break;
-									}
-							coord[atom_index][0] = x;
-							coord[atom_index][1] = y;
-							coord[atom_index++][2] = z;
+							class = classify_atom(atom_index,last_residue_index,aacode,name);
+							store_atom(atom_index++,last_residue_index,class,serial,name,x,y,z);
 							/*break;*/
 						} /* end if (i == -1)*/
 					else is_helical = false;
@@ -1105,7 +1175,8 @@ XXX delete this crap*/
 			helix_residue_iCode[i], helix_chain[helix_no[i]], helix_no[i]);
 
 		printf("\nThese are the atoms in the above residues:\n\n");
-		for (i = 0; i < atom_index; i++)
+		if (setflag[flag_m]) printf("\t(%d atoms, not stored as -m is set)\n",atom_index);
+		else for (i = 0; i < atom_index; i++)
 			printf("\t%d) %s %d %8.3f %8.3f %8.3f  residue %d (%s %d iCode='%c' %c)\n",i, atom_name[i], atom_no[i], coord[i][0], coord[i][1], coord[i][2], atom_res[i],helix_residue_name[atom_res[i]], helix_residue_no[atom_res[i]], helix_residue_iCode[atom_res[i]], helix_chain[helix_no[atom_res[i]]]);
 
 		printf("\nThese are the reference atoms for each residue:\n\n");
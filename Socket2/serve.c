@@ -0,0 +1,552 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					serve.c
+
+
+Description: this C program identifies coiled-coil motifs in a Protein Data Bank
+(Berman et al, Nucleic Acids Res v28 pp235-42, 2000) file. Also required as
+input is a DSSP (Kabsch & Sander, Biopolymers v22 pp 2577-637) file derived from
+the PDB file.
+
+
+*/
+
+/*					serve.c
+					-------
+
+The daemon (--serve <socket>): SOCKET listens on a Unix domain socket, and
+analyses each request made on it, so that a caller (a notebook, a web front end)
+does not pay for starting the program, and for setting up its tables and
+arrays, with every structure.
+
+The daemon does that setting up once (statchar(), initialize()), and then
+forks a pool of --workers worker processes (default: one per processor), so
+that each starts warm, as a copy of the initialized program. Each worker
+accepts one connection, analyses its request and answers it, and exits; the
+daemon then forks another in its place. A worker starts every request from
+the same clean state, and a request which fails (SOCKET exits on bad input)
+costs only its own worker; the number of workers is the most requests analysed
+at once, and any more wait on the socket for a free worker.
+
+A request is a line of arguments, as on the command line (separated by white
+space), optionally followed by the PDB and DSSP files themselves, each as a
+line 'PDB <bytes>' or 'DSSP <bytes>' and then that many bytes; it ends with an
+empty line (or when the caller closes its end). Files sent inline are read from
+memory; -f and -s then only name them (for the code), and may be left out. e.g.
+
+	-f /data/2zta.pdb -s /data/2zta.dssp -c 7.4
+	<empty line>
+or
+	-f 2zta.pdb -q
+	PDB 81234
+	<81234 bytes of PDB file>DSSP 20345
+	<20345 bytes of DSSP file>
+	<empty line>
+
+A request may not name an output file, as the daemon writes only into its
+answers: -K is refused, and -J, -o, -r, -w, -d and --trace may only be given
+as '-' (e.g. '-o - -r -'), which asks for that file in the answer.
+
+The whole request must arrive within REQUEST_TIMEOUT seconds of the connection
+being accepted; otherwise it is answered with an error, so that callers which
+connect and send nothing (or send slowly) cannot hold up the workers, and every
+caller after them. An inline file larger than MAX_REQUEST_FILE bytes is
+refused, as it would be read whole into memory.
+
+The answer is one JSON document, after which the worker closes the connection:
+
+	status		"ok", or "error" if the analysis did not finish
+	worker		the process id of the worker
+	result		(only if "ok") the results, as written by -J (see
+			json.c); -J is implied
+	long, rasmol,	(only if "ok", and asked for with -o, -r, -w, -d or
+	register,	--trace '-') the text of that output file
+	summary, trace
+	output		everything the analysis wrote to standard output (the
+			results in text, and any error message)
+	timing		the seconds taken to receive the request, to analyse it
+			(from the arguments to the results; null if it did not
+			finish), and in all, from accepting the connection to
+			answering it
+
+Each answer is also logged by the worker on standard error, as a line
+beginning SERVE. The daemon stops, removing the socket, on SIGTERM or SIGINT.
+It replaces a socket left by an earlier daemon, but will not start if the name
+it is given is anything else (such as a file), which it leaves alone.
+
+The socket is created readable and writable by the daemon's user only, as
+anyone who can connect to it has structures analysed (and the PDB and DSSP
+files named in requests read) as that user; to serve others, loosen the
+permissions of the socket, or serve it from a directory they can reach.
+*/
+
+#include "socket.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+
+static pid_t worker_pid[MAX_WORKERS];
+static volatile sig_atomic_t stopping = 0;
+static sigset_t original_mask;
+
+/* the worker's connection, and its answer */
+static FILE *response,
+	*output,			/* standard output of the analysis */
+	*result;			/* the JSON document of the analysis */
+static double accepted, received, analysed;
+static enum boolean finished = false;
+static volatile sig_atomic_t timed_out = 0;
+
+/* the output files a request may ask for, with '-' (see worker()): each is
+written into the worker's own directory, and sent as a field of the answer */
+#define SERVED_OUTPUTS 5
+static int output_par[SERVED_OUTPUTS] = {par_d,par_o,par_r,par_w,par_trace};
+static char *output_field[SERVED_OUTPUTS] = {"summary","long","rasmol","register","trace"};
+static char output_dir[32] = "",
+	output_file_name[SERVED_OUTPUTS][48];
+static enum boolean output_asked[SERVED_OUTPUTS];
+
+
+static void stop(int signal_number)
+	{
+	(void) signal_number;
+	stopping = 1;
+	}
+
+static void child_ended(int signal_number)
+	{
+	(void) signal_number;
+	}
+
+static void request_timeout(int signal_number)
+	{
+	(void) signal_number;
+	timed_out = 1;
+	}
+
+
+/* whether name is a socket (and not, say, a file which a mistyped --serve
+names, and which must not be removed) */
+
+static enum boolean is_socket(char name[])
+	{
+	struct stat status;
+
+	return (enum boolean) ((lstat(name,&status) == 0) && S_ISSOCK(status.st_mode));
+	}
+
+
+/* writes the character c within a JSON string; the output is Latin-1 */
+
+static void json_output_char(FILE *out, int c)
+	{
+	if ((c == '"') || (c == '\\')) fprintf(out,"\\%c",c);
+	else if (c == '\n') fprintf(out,"\\n");
+	else if ((c < ' ') || (c > '~')) fprintf(out,"\\u%04x",c);
+	else fputc(c,out);
+	}
+
+
+/* answers the request; registered with atexit(), so that a request is answered
+whether its analysis finishes or SOCKET exits on an error */
+
+static void answer()
+	{
+	double now;
+	FILE *file;
+	int c,i;
+
+	/* the output files are not closed by the analysis */
+	fflush(NULL);
+	now = monotonic_seconds();
+	if (received == 0.0) received = now;
+
+	fprintf(response,"{\"status\":\"%s\",\"worker\":%d,\n",finished ? "ok" : "error",(int) getpid());
+	if (finished)
+		{
+		fprintf(response,"\"result\":");
+		rewind(result);
+		while ((c = getc(result)) != EOF) putc(c,response);
+		fprintf(response,",\n");
+		for (i = 0; i < SERVED_OUTPUTS; i++)
+			if (output_asked[i] && ((file = fopen(output_file_name[i],"r")) != NULL))
+				{
+				fprintf(response,"\"%s\":\"",output_field[i]);
+				while ((c = getc(file)) != EOF) json_output_char(response,c);
+				fprintf(response,"\",\n");
+				fclose(file);
+				}
+		}
+	for (i = 0; i < SERVED_OUTPUTS; i++) if (output_asked[i]) unlink(output_file_name[i]);
+	if (output_dir[0]) rmdir(output_dir);
+
+	fprintf(response,"\"output\":\"");
+	rewind(output);
+	while ((c = getc(output)) != EOF) json_output_char(response,c);
+	fprintf(response,"\",\n\"timing\":{\"receive\":%.6f,\"analysis\":",received - accepted);
+	if (finished) fprintf(response,"%.6f",analysed - received);
+	else fprintf(response,"null");
+	fprintf(response,",\"total\":%.6f}}\n",now - accepted);
+	fclose(response);
+
+	fprintf(stderr,"SERVE %d %s %s receive=%.6f total=%.6f\n",(int) getpid(),
+		finished ? "ok" : "error",code[0] ? code : "-",received - accepted,now - accepted);
+	}
+
+
+/* exits, with an error for the answer, if reading the request failed (rather
+than its simply ending): because it took more than REQUEST_TIMEOUT seconds in
+all, or for any one part of it (see worker()), or for any other reason */
+
+static void check_received(FILE *request)
+	{
+	if (timed_out || (ferror(request) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))))
+		{
+		printf("the request was not received within %d seconds\n\n",REQUEST_TIMEOUT);
+		exit(1);
+		}
+	if (ferror(request))
+		{
+		printf("the request could not be read: %s\n\n",strerror(errno));
+		exit(1);
+		}
+	}
+
+
+/* refuses a request which names an output file: the daemon writes only into
+the answer. Each output file but the knob columns (-K, a table built up over
+many runs) may be asked for with '-' instead of a file name, and is then sent
+as a field of the answer (as are the results of -J, whether asked for or not) */
+
+static void refuse_output_files()
+	{
+	int i;
+
+	if (par[par_K] != NULL)
+		{
+		printf("a request cannot write knob columns (-K); the knobs are in the result\n\n");
+		exit(1);
+		}
+	if ((par[par_J] != NULL) && strcmp(par[par_J],"-"))
+		{
+		printf("a request cannot name an output file (-J %s); the result is in the answer\n\n",par[par_J]);
+		exit(1);
+		}
+	for (i = 0; i < SERVED_OUTPUTS; i++)
+		{
+		output_asked[i] = false;
+		if (par[output_par[i]] == NULL) continue;
+		if (strcmp(par[output_par[i]],"-"))
+			{
+			printf("a request cannot name an output file (-%s %s); give '-' instead, for the "
+				"file in the answer, as \"%s\"\n\n",parname[output_par[i]],par[output_par[i]],
+				output_field[i]);
+			exit(1);
+			}
+		output_asked[i] = true;
+		}
+	}
+
+
+/* reads an inline file of the request, whose header line is header, into
+served_pdb or served_dssp */
+
+static void read_inline_file(FILE *request, char header[])
+	{
+	char kind[8];
+	long bytes;
+	char **text;
+	size_t *size;
+
+	if ((sscanf(header,"%7s %ld",kind,&bytes) != 2) || (bytes < 0))
+		{
+		printf("the request has a bad line: %s\n",header);
+		exit(1);
+		}
+	if (!strcmp(kind,"PDB")) { text = &served_pdb; size = &served_pdb_size; }
+	else if (!strcmp(kind,"DSSP")) { text = &served_dssp; size = &served_dssp_size; }
+	else
+		{
+		printf("the request has a bad line: %s\n",header);
+		exit(1);
+		}
+	if (bytes > MAX_REQUEST_FILE)
+		{
+		printf("the %s file of the request (%ld bytes) is larger than %ld bytes\n\n",kind,
+			bytes,MAX_REQUEST_FILE);
+		exit(1);
+		}
+
+	if ((*text = malloc(bytes + 1)) == NULL)
+		{
+		printf("no memory for the %ld bytes of the %s file\n\n",bytes,kind);
+		exit(1);
+		}
+	if (fread(*text,1,bytes,request) != (size_t) bytes)
+		{
+		check_received(request);
+		printf("the request ended before the %ld bytes of its %s file\n\n",bytes,kind);
+		exit(1);
+		}
+	(*text)[bytes] = '\0';
+	*size = bytes;
+	}
+
+
+/* reads the request: its arguments into arg[] (arg[0] being the program), and
+any inline files; the number of arguments */
+
+static int read_request(FILE *request, char line[], char *arg[])
+	{
+	char header[MAX_LINE_WIDTH], *word;
+	int args;
+
+	if (fgets(line,MAX_REQUEST_LENGTH,request) == NULL)
+		{
+		check_received(request);
+		printf("the request was empty\n\n");
+		exit(1);
+		}
+	if ((strchr(line,'\n') == NULL) && !feof(request))
+		{
+		check_received(request);
+		printf("the arguments of the request are longer than %d characters\n\n",MAX_REQUEST_LENGTH);
+		exit(1);
+		}
+
+	args = 0;
+	arg[args++] = "socket2";
+	for (word = strtok(line," \t\r\n"); word != NULL; word = strtok(NULL," \t\r\n"))
+		{
+		if (args > MAX_REQUEST_ARGS)
+			{
+			printf("the request has more than %d arguments\n\n",MAX_REQUEST_ARGS);
+			exit(1);
+			}
+		arg[args++] = word;
+		}
+	arg[args] = NULL;
+
+	while ((fgets(header,MAX_LINE_WIDTH,request) != NULL) && strcmp(header,"\n") && strcmp(header,"\r\n"))
+		read_inline_file(request,header);
+	check_received(request);
+
+	return args;
+	}
+
+
+/* a worker: accepts one connection, analyses its request, answers it, and
+exits */
+
+static void worker(int listener)
+	{
+	char line[MAX_REQUEST_LENGTH], *arg[MAX_REQUEST_ARGS+2];
+	int connection, args, i;
+	struct sigaction action;
+	struct timeval timeout;
+	FILE *request;
+
+	signal(SIGTERM,SIG_DFL);
+	signal(SIGINT,SIG_DFL);
+	signal(SIGCHLD,SIG_DFL);
+	sigprocmask(SIG_SETMASK,&original_mask,NULL);
+
+	while ((connection = accept(listener,NULL,NULL)) < 0)
+		if (errno != EINTR)
+			{
+			perror("SERVE accept");
+			exit(1);
+			}
+	accepted = monotonic_seconds();
+	close(listener);
+
+	/* from here on, the request is answered whatever happens; the output of
+	the analysis is gathered, to be sent with the answer */
+	fflush(stdout);
+	if (((output = tmpfile()) == NULL) || ((result = tmpfile()) == NULL) ||
+		((response = fdopen(connection,"w")) == NULL) ||
+		((request = fdopen(dup(connection),"r")) == NULL))
+		{
+		perror("SERVE");
+		exit(1);
+		}
+	dup2(fileno(output),1);
+	atexit(answer);
+
+	/* a caller cannot hold the worker by sending its request slowly, or not
+	at all: the whole request must arrive within REQUEST_TIMEOUT seconds
+	(SIGALRM interrupts the read, as it is not restarted), and so must each
+	read of it and each write of the answer, in case the alarm falls between
+	reads */
+	timeout.tv_sec = REQUEST_TIMEOUT;
+	timeout.tv_usec = 0;
+	setsockopt(connection,SOL_SOCKET,SO_RCVTIMEO,&timeout,sizeof(timeout));
+	setsockopt(connection,SOL_SOCKET,SO_SNDTIMEO,&timeout,sizeof(timeout));
+	memset(&action,0,sizeof(action));
+	sigemptyset(&action.sa_mask);
+	action.sa_handler = request_timeout;
+	sigaction(SIGALRM,&action,NULL);
+	alarm(REQUEST_TIMEOUT);
+
+	args = read_request(request,line,arg);
+	alarm(0);
+	received = monotonic_seconds();
+
+	for (i = 0; i < FLAGS; i++) setflag[i] = false;
+	for (i = 0; i < PARS; i++) par[i] = NULL;
+	set_flagsNpars(args,arg);
+	if ((par[par_serve] != NULL) || (par[par_workers] != NULL))
+		{
+		printf("a request cannot itself serve (--serve, --workers)\n\n");
+		exit(1);
+		}
+	refuse_output_files();
+	if ((served_pdb != NULL) && (par[par_f] == NULL)) par[par_f] = "inline";
+	if ((served_dssp != NULL) && (par[par_s] == NULL)) par[par_s] = "inline";
+	read_parameters();
+
+	/* the output files asked for are written into a directory of the
+	worker's own, and sent with the answer */
+	for (i = 0; i < SERVED_OUTPUTS; i++)
+		if (output_asked[i])
+			{
+			if ((output_dir[0] == '\0') && (mkdtemp(strcpy(output_dir,"/tmp/socket2.XXXXXX")) == NULL))
+				{
+				output_dir[0] = '\0';
+				printf("Failed to create a directory for the output files: %s\n\n",strerror(errno));
+				exit(1);
+				}
+			sprintf(output_file_name[i],"%s/%s",output_dir,output_field[i]);
+			par[output_par[i]] = output_file_name[i];
+			}
+
+	/* -J is implied: the results go into the answer (write_json() closes
+	json_file, so it is given a file of its own, on the same temporary file) */
+	par[par_J] = NULL;
+	check_files();
+	par[par_J] = "(answer)";
+	if ((json_file = fdopen(dup(fileno(result)),"w")) == NULL)
+		{
+		perror("SERVE");
+		exit(1);
+		}
+
+	analyse_structure();
+	analysed = monotonic_seconds();
+	finished = true;
+	exit(0);
+	}
+
+
+static void start_worker(int w, int listener)
+	{
+	fflush(stdout);
+	fflush(stderr);
+	if ((worker_pid[w] = fork()) < 0)
+		{
+		perror("SERVE fork");
+		exit(1);
+		}
+	if (worker_pid[w] == 0) worker(listener);
+	}
+
+
+void serve(char socket_name[])
+	{
+	struct sockaddr_un address;
+	struct sigaction action;
+	sigset_t blocked;
+	int listener, workers, status, w, bound = -1;
+	mode_t mask;
+	pid_t pid;
+
+	if (par[par_workers] == NULL) workers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+	else sscanf(par[par_workers],"%i",&workers);
+	if (workers < 1) workers = 1;
+	if (workers > MAX_WORKERS)
+		{
+		printf("number of workers must be between 1 and %d\n\n",MAX_WORKERS);
+		exit(1);
+		}
+
+	if (strlen(socket_name) >= sizeof(address.sun_path))
+		{
+		printf("the socket name \"%s\" is too long\n\n",socket_name);
+		exit(1);
+		}
+	memset(&address,0,sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path,socket_name);
+
+	/* a socket left by an earlier daemon is replaced, but anything else of
+	that name is left alone; the socket is created readable and writable by
+	the daemon's user only (whatever the umask), as anyone who can connect to
+	it has analyses run as that user */
+	if (is_socket(socket_name)) unlink(socket_name);
+	else if (access(socket_name,F_OK) == 0)
+		{
+		printf("\"%s\" exists and is not a socket: not serving on it\n\n",socket_name);
+		exit(1);
+		}
+	if ((listener = socket(AF_UNIX,SOCK_STREAM,0)) >= 0)
+		{
+		mask = umask(0177);
+		bound = bind(listener,(struct sockaddr *) &address,sizeof(address));
+		umask(mask);
+		}
+	if ((listener < 0) || (bound < 0) || (listen(listener,SOMAXCONN) < 0))
+		{
+		printf("Failed to serve on \"%s\": %s\n\n",socket_name,strerror(errno));
+		exit(1);
+		}
+
+	/* the daemon waits for its workers with these signals blocked, other than
+	in sigsuspend(), so that none is missed */
+	sigemptyset(&blocked);
+	sigaddset(&blocked,SIGCHLD);
+	sigaddset(&blocked,SIGTERM);
+	sigaddset(&blocked,SIGINT);
+	sigprocmask(SIG_BLOCK,&blocked,&original_mask);
+	memset(&action,0,sizeof(action));
+	sigemptyset(&action.sa_mask);
+	action.sa_handler = stop;
+	sigaction(SIGTERM,&action,NULL);
+	sigaction(SIGINT,&action,NULL);
+	action.sa_handler = child_ended;
+	sigaction(SIGCHLD,&action,NULL);
+	/* a caller which hangs up only fails its own answer */
+	signal(SIGPIPE,SIG_IGN);
+
+	printf("serving on \"%s\" with %d workers\n",socket_name,workers);
+	for (w = 0; w < workers; w++) start_worker(w,listener);
+
+	while (!stopping)
+		{
+		while (!stopping && ((pid = waitpid(-1,&status,WNOHANG)) > 0))
+			{
+			for (w = 0; w < workers; w++) if (worker_pid[w] == pid) break;
+			if (w == workers) continue;
+			if (WIFSIGNALED(status))
+				fprintf(stderr,"SERVE %d killed by signal %d\n",(int) pid,WTERMSIG(status));
+			start_worker(w,listener);
+			}
+		if (!stopping) sigsuspend(&original_mask);
+		}
+
+	for (w = 0; w < workers; w++) kill(worker_pid[w],SIGTERM);
+	while (wait(NULL) > 0);
+	close(listener);
+	if (is_socket(socket_name)) unlink(socket_name);
+	printf("stopped serving on \"%s\"\n",socket_name);
+	exit(0);
+	}
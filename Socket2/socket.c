@@ -35,62 +35,101 @@ the PDB file.
 
 #include "aminoa2.h"
 
+/* main() is left out of builds (-DNO_MAIN) which call the functions of SOCKET
+from a main() of their own, e.g. bench/microbench.c */
+
+#ifndef NO_MAIN
+
 /* GNU c compiler complains if main() does not return type int */
 int main(int argc, char *argv[])
 	{
-	int i,/*j,k, last_residue_index,*/ residue_index,
-		 atom_index;
-
-/*	char lastchain; */
-/*	enum amino_acid ;*/
-
 	printf(SOCKET_TITLE);
 
 	statchar();
 
 	initialize(argc,argv);
 
+	/* as a daemon (--serve), each request is analysed by a worker process, as
+	below (see serve.c); serve() never returns */
+	if (par[par_serve] != NULL)
+		serve(par[par_serve]);
+
 	check_files();
 
+	analyse_structure();
+
+	return(0);
+	/* end of main() */
+	}
+
+#endif
+
+void analyse_structure()
+	{
+	int i,/*j,k, last_residue_index,*/ residue_index,
+		 atom_index;
+
+/*	char lastchain; */
+/*	enum amino_acid ;*/
+
+	stage_begin(stage_dssp);
 	if (extend)
 		pre_parse_dssp(&helix_index, helix_start, helix_start_iCode,
 		helix_end, helix_end_iCode, helix_chain, extend);
 
 /* read in the alpha-helical residues from the DSSP file */
 	residue_index = read_helical_dssp(extend);
+	index_helix_residues(residue_index);
+	stage_end(stage_dssp);
 
 	/* next line should now be redundant */
 	/*if (extend)
 		prune_extended_helices(residue_index, helix_index, helix_start, helix_end, helix_chain);*/
 
+	stage_begin(stage_pdb);
 	atom_index = read_helical_pdb();
+	stage_end(stage_pdb);
 
-	determine_centre_of_mass(atom_index);
+	stage_begin(stage_centres);
+	determine_centre_of_mass(residue_index,atom_index);
+	stage_end(stage_centres);
+	stage_begin(stage_ends);
 	determine_end(residue_index,atom_index);
+	stage_end(stage_ends);
+	stage_begin(stage_axes);
+	determine_helix_axes(residue_index);
+	stage_end(stage_axes);
 
 	if (setflag[flag_v])
 		{
 		printf("\nThese are the reference coordinates for each residue:\n\n");
 		for (i = 0; i < residue_index; i++)
 			printf("\tresidue %d) end: %8.3f,%8.3f,%8.3f; centre of volume: %8.3f,%8.3f,%8.3f\n",
-			i,refatom1B[i][0],refatom1B[i][1],refatom1B[i][2],refatom2[i][0],refatom2[i][1],refatom2[i][2]);
+			i,residue_geometry[i].end[0],residue_geometry[i].end[1],residue_geometry[i].end[2],refatom2[i][0],refatom2[i][1],refatom2[i][2]);
 		printf("\n");
 		}
 
+	stage_begin(stage_knobs);
 	find_knobs_and_holes(residue_index);
+	stage_end(stage_knobs);
 
 	/*if ((par[par_d] != NULL) || (par[par_o] != NULL))
 		write_files(residue_index);*/
 
 	/* determine_order returns the number of coiled coils as specified
 	by any helix-helix kih interactions */
+	stage_begin(stage_order);
 	n_total_ccs = determine_order(residue_index);
+	stage_end(stage_order);
 	if (n_total_ccs)
 		{
 		/* find_register returns the number of the above coiled coils
 		which are 'real', after weeding out those which dont have enough
 		complementary knobs for example */
-		n_true_ccs = find_register(residue_index);
+		stage_begin(stage_register);
+		n_true_ccs = find_register();
+		stage_end(stage_register);
+		work_count[count_coiled_coils] = n_true_ccs;
 
 		if (n_true_ccs)
 			{
@@ -116,24 +155,79 @@ int main(int argc, char *argv[])
 		different subroutines, including main() - see above - , 
 		determine_order() and find_register() */
 
+	stage_begin(stage_write);
 	if ((par[par_d] != NULL) || (par[par_o] != NULL))
 		write_files(residue_index);
 
+	/* the JSON document (-J) holds all of the above */
+
+	if (par[par_J] != NULL)
+		write_json(residue_index);
+
+	/* the knob table (-K) grows by one row per knob with each run */
+
+	if (par[par_K] != NULL)
+		write_knob_columns(par[par_K]);
+	stage_end(stage_write);
+
+	report_profile();
+	report_counters();
+	report_memory(residue_index,atom_index);
+
+	if (tracing)
+		close_trace();
 
 	printf("Finished\n");
-	return(0);
-	/* end of main() */
-	}
+	} /* end of analyse_structure */
 
 void initialize(int argc, char *argv[])
 	{
 	int i,j,l;
-	char temp[4];
 
 	aa_map();
 
 	set_flagsNpars(argc,argv);
 
+	read_parameters();
+
+	for (i = 0; i < MAX_RESIDUES; i++)
+		{
+		refatom0[i] = -1;
+		refatom1[0][i] = -1;
+		refatom1[1][i] = -1;
+		for (j = 0; j < 3; j++) refatom2[i][j] = 99999.9;
+		}
+
+	for (i = 0; i < MAX_HELICES; i++) {n_knobs[i] = 0; n_hole_res[i] = 0;}
+
+	for (i = 0; i < MAX_SEQCHAINS; i++)
+		{
+		seqchain[i] = NULL_SEQCHAIN;
+		}
+
+	for (i = 0; i < MAX_COILED_COILS; i++)
+		{
+		coiled_coil_tally[i] = 0;
+		coiled_coil_helices[i] = 0;
+		coiled_coil_subset[i] = -2;
+		for (j = 0; j <  MAX_HELICES_PER_COIL; j++)
+			{
+			coiled_coil[i][j] = -1;
+			for (l = 0; l < 2; l++)
+				{
+				coiled_coil_begin[i][j][l] = -1;
+				coiled_coil_end[i][j][l] = -1;
+				}
+			}
+		}
+
+	} /* end of initialize */
+
+void read_parameters()
+	{
+	int i,j,l;
+	char temp[4];
+
 	if (par[par_c] == NULL) cutoff2 = DEFAULT_CUTOFF2;
 	else sscanf(par[par_c],"%f",&cutoff2);
 
@@ -176,20 +270,12 @@ void initialize(int argc, char *argv[])
 		for (i = 0; i < 5; i++) refatom0type[i] = toupper(refatom0type[i]);
 		}
 
+	refatom0key = atom_key(refatom0type);
+
 	/*printf("Reference atom type is \"%s\"\n\n",refatom0type); */
 	if (strcmp(refatom0type," CA ")) printf("- packing geometry cannot be calculated (requires C alpha atoms)\n");
 	
 
-	for (i = 0; i < MAX_RESIDUES; i++)
-		{
-		refatom0[i] = -1;
-		refatom1[0][i] = -1;
-		refatom1[1][i] = -1;
-		for (j = 0; j < 3; j++) refatom2[i][j] = 99999.9;
-		}
-
-	for (i = 0; i < MAX_HELICES; i++) {n_knobs[i] = 0; n_hole_res[i] = 0;}
-
 	if (setflag[flag_debug])
 		{
 		for (i = 0; i < FLAGS; i++)
@@ -211,29 +297,14 @@ void initialize(int argc, char *argv[])
 	else sscanf(par[par_e],"%i",&extend);
 	if (extend) printf("Helices defined by DSSP file will be extended by %d residues at each end\n",extend);
 
-
-	for (i = 0; i < MAX_SEQCHAINS; i++)
-		{
-		seqchain[i] = NULL_SEQCHAIN;
-		}
-
-	for (i = 0; i < MAX_COILED_COILS; i++)
-		{
-		coiled_coil_tally[i] = 0;
-		coiled_coil_helices[i] = 0;
-		coiled_coil_subset[i] = -2;
-		for (j = 0; j <  MAX_HELICES_PER_COIL; j++)
-			{
-			coiled_coil[i][j] = -1;
-			for (l = 0; l < 2; l++)
-				{
-				coiled_coil_begin[i][j][l] = -1;
-				coiled_coil_end[i][j][l] = -1;
-				}
-			}
+	if (par[par_j] == NULL) threads = 1;
+	else sscanf(par[par_j],"%i",&threads);
+	if ((threads < 1) || (threads > MAX_THREADS)) {
+		printf("number of threads must be between 1 and %d\n\n",MAX_THREADS);
+		exit(1);
 		}
 
-	} /* end of initialize */
+	} /* end of read_parameters */
 
 void check_files()
 	{
@@ -249,9 +320,13 @@ void check_files()
 		exit(1);
 		}
 
+	/* the PDB and DSSP files of a request to the daemon may come inline
+	(see serve.c), in which case -f and -s only name them */
 	strcpy(pdb_file_name,par[par_f]);
 	if (!setflag[flag_p]) printf("attempting to open \"%s\"\n",pdb_file_name);
-	if ( (pdb_file = fopen(pdb_file_name,"r") ) == NULL)
+	if (served_pdb != NULL) pdb_file = fmemopen(served_pdb,served_pdb_size,"r");
+	else pdb_file = fopen(pdb_file_name,"r");
+	if (pdb_file == NULL)
 		{
 		if (!setflag[flag_p]) printf("Failed to open PDB file \"%s\"\n\n",pdb_file_name);
 		exit(1);
@@ -268,7 +343,9 @@ void check_files()
 		}
 	strcpy(dssp_file_name,par[par_s]);
 
-	if ( (dssp_file = fopen(dssp_file_name,"r") ) == NULL)
+	if (served_dssp != NULL) dssp_file = fmemopen(served_dssp,served_dssp_size,"r");
+	else dssp_file = fopen(dssp_file_name,"r");
+	if (dssp_file == NULL)
 		{
 		if (!setflag[flag_p]) printf("Failed to open DSSP file \"%s\"\n\n",dssp_file_name);
 		exit(1);
@@ -290,6 +367,22 @@ void check_files()
 			fprintf(rasmol_file,"echo\nselect\nwireframe off\nspacefill off\nribbon off\ndots off\nbackbone off\nstrands off\n");
 		}
 
+	if (par[par_J] != NULL)
+		{
+		if ( (json_file = fopen(par[par_J],"w") ) == NULL)
+			{
+			if (!setflag[flag_p]) printf("Failed to open JSON file \"%s\"\n\n",par[par_J]);
+			exit(1);
+			}
+		if (!setflag[flag_p]) printf("opened \"%s\" (output)\n",par[par_J]);
+		}
+
+	if (par[par_trace] != NULL)
+		open_trace(par[par_trace]);
+
+	if (setflag[flag_perf])
+		open_counters();
+
 	if (par[par_d] != NULL)
 		{  
 		strcpy(data_outfile_name,par[par_d]);
@@ -333,7 +426,7 @@ void check_files()
 
 void write_files(int residue_index)
 	{
-	int i,j,k,l,m,n;
+	int h,i,j,k,l,m,n;
 	char knob_pattern[3][MAX_KNOBS_PER_HELIX*2],s[20];
 	static char* orientation_id = {"pa"};
 
@@ -381,11 +474,11 @@ void write_files(int residue_index)
 				/* print out ALL the register assignments for this residue (there can be more than one; some
 				residues can simultaneously belong to 2 coiled coils) */
 
-				for (n = 0; n < MAX_COILED_COILS; n++)
+				for (m = residue_register_start[j]; m < residue_register_start[j+1]; m++)
 					{
-					if ((coiled_coil_subset[n] == -1) && 
-						(tad_register[j][n] != ' ') && (tad_register[j][n] != 0))
-						fprintf(long_outfile,"R%c[%d%c]",tad_register[j][n],
+					n = residue_register_cc[m];
+					if (coiled_coil_subset[n] == -1)
+						fprintf(long_outfile,"R%c[%d%c]",get_register(j,n),
 							coiled_coil_helices[n],orientation_id[coiled_coil_orientation[n]]);
 					}
 
@@ -396,7 +489,7 @@ void write_files(int residue_index)
 					}
 				k = 0;
 
-				while ((knob[k] != j) && (k < knob_index)) k++;
+				while ((knob[k].residue != j) && (k < knob_index)) k++;
 
 				if (k == knob_index)
 					{
@@ -405,45 +498,47 @@ void write_files(int residue_index)
 					}
 				else
 					{
-					knob_pattern[0][l] = '0' + knobtype[k];
+					knob_pattern[0][l] = '0' + knob[k].type;
 					/*knob_pattern[1][l] = '-';*/
 
 					if (par[par_o] != NULL) {
 						/* prints the knobtype, helix id and packing angle */
 						fprintf(long_outfile," T%1d H%3d:%8.3f ; ",
-							knobtype[k],helix_no[hole[k][0]],angle[k]);
+							knob[k].type,helix_no[knob[k].hole[0]],knob_geometry[k].angle);
 						/* prints the list of 4 hole residues to the file */
 
-						for (n = 0; n < MAX_COILED_COILS; n++)
+						/* the coiled coils in which the hole has a register are
+						those of its second residue */
+
+						for (h = residue_register_start[knob[k].hole[1]];
+							h < residue_register_start[knob[k].hole[1]+1]; h++)
 							{
-							if ((coiled_coil_subset[n] == -1) &&
-								(tad_register[hole[k][1]][n] != ' ') && (tad_register[j][n] != 0))
+							n = residue_register_cc[h];
+							if (coiled_coil_subset[n] == -1)
 								{
 								fprintf(long_outfile,"hole (");
 								for (m = 0; m < 4; m++)
-									fprintf(long_outfile,"%c",tad_register[hole[k][m]][n]);
+									fprintf(long_outfile,"%c",get_register(knob[k].hole[m],n));
 								fprintf(long_outfile,") ");
 								}
 							}
 
-						fprintf(long_outfile,"chain %c: ",helix_chain[helix_no[hole[k][0]]]);
+						fprintf(long_outfile,"chain %c: ",helix_chain[helix_no[knob[k].hole[0]]]);
                                                 /* JW 13-7-6 amended print statement so that it prints the CoV separation
 						   of the knob and each of the 4 hole sidechains */
 						for (m = 0; m < 4; m++)
 							fprintf(long_outfile," (%d) %s%5d'%c' %8.3f",m,
-								helix_residue_name[hole[k][m]],
-								helix_residue_no[hole[k][m]],
-								helix_residue_iCode[hole[k][m]],
-								hole_distance[k][m]);
-						/* calculate and print out the hole dimensions, ie the lengths of its four
+								helix_residue_name[knob[k].hole[m]],
+								helix_residue_no[knob[k].hole[m]],
+								helix_residue_iCode[knob[k].hole[m]],
+								knob_geometry[k].hole_distance[m]);
+						/* print out the hole dimensions, ie the lengths of its four
 							sides: distances h0-h1 , h0-h2, h1-h3, h2-h3 , where h0, h1 , h2, h3 are the
 							centres of volume respectively of the four hole residues in serial
 							order (usually, if h0 is residue x, then h1 is x+3, h2 is x+4, h3 is x+7) */
 						fprintf(long_outfile,"; sides 0-1:%8.3f, 0-2:%8.3f, 1-3:%8.3f, 2-3:%8.3f",
-							measure_centre_distance(hole[k][0],hole[k][1]),
-							measure_centre_distance(hole[k][0],hole[k][2]),
-							measure_centre_distance(hole[k][1],hole[k][3]),
-							measure_centre_distance(hole[k][2],hole[k][3]));
+							knob_geometry[k].side[0],knob_geometry[k].side[1],
+							knob_geometry[k].side[2],knob_geometry[k].side[3]);
 						}
 					}
 
@@ -451,10 +546,10 @@ void write_files(int residue_index)
 					{
 					/*if (strcmp(knob_pattern[2],"")) strcat(knob_pattern[2],",");
 					strcat(knob_pattern[2],"-");*/
-					if (knob[k] == j)
+					if (knob[k].residue == j)
 						{
 						if (strcmp(knob_pattern[2],"")) strcat(knob_pattern[2],",");
-						sprintf(s,"%d",helix_no[hole[k][0]]);
+						sprintf(s,"%d",helix_no[knob[k].hole[0]]);
 						strcat(knob_pattern[2],s);
 						}
 					}
@@ -477,7 +572,7 @@ printf("checkpoint 4 i = %d, j = %d, l = %d, \"%s\", \"%s\"\n",i,j,l,knob_patter
 
 			/* prints the helix containing the hole in which each knob fits */
 			/*for (j = 0; j < n_knobs[i]; j++)
-				fprintf(data_outfile,"\t%d",helix_no[hole[j][0]]);*/
+				fprintf(data_outfile,"\t%d",helix_no[knob[j].hole[0]]);*/
 			fprintf(data_outfile,"\n");
 			}
 		}
@@ -581,9 +676,9 @@ void dumpknobs(int aknob)
 	for (i = 0; i < knob_index; i++)
 		{
 		if ((i == aknob) || (aknob == -1))
-		printf("knob %3d: knob[%d]=%3d hole[%d][0]=%3d hole[%d][1]=%3d hole[%d][2]=%3d hole[%d][3]=%3d knobtype[%d]=%d knob_order[%d]=%d angle[%d]=%8.3f n_compknob[%d]=%d ",
-i,i,knob[i],i,hole[i][0],i,hole[i][1],i,hole[i][2],i,hole[i][3],i,knobtype[i],i,knob_order[i],i,angle[i],i,n_compknob[i]);
-	for (j = 0; j < n_compknob[i]; j++) printf("compknob[%d][%d] = %d; ",i,j,compknob[i][j]);
+		printf("knob %3d: knob[%d].residue=%3d .hole[0]=%3d .hole[1]=%3d .hole[2]=%3d .hole[3]=%3d .type=%d .order=%d angle[%d]=%8.3f .n_compknob=%d ",
+i,i,knob[i].residue,knob[i].hole[0],knob[i].hole[1],knob[i].hole[2],knob[i].hole[3],knob[i].type,knob[i].order,i,knob_geometry[i].angle,knob[i].n_compknob);
+	for (j = 0; j < knob[i].n_compknob; j++) printf(".compknob[%d] = %d; ",j,knob[i].compknob[j]);
 		printf("\n");
 		}
 	}
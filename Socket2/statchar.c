@@ -46,13 +46,15 @@ void statchar()
 	/* the names of the available flags, as specified by the user on the command-
 	line when preceded directly by '-' */
 
-	static char *local_flagname[FLAGS] = {"debug","a","b","i","l","p","q","u","v"};
+	static char *local_flagname[FLAGS] = {"debug","a","b","i","l","m","p","q","T","u","v","x",
+		"-perf","-mem-report","-legacy"};
 
 
 	/* the names of the available parameters, as specified by the user on the
 	command-line when preceded directly by '-' */
 
-	static char *local_parname[PARS] = {"c","d","e","f","j","k","o","r","s","t","w"};
+	static char *local_parname[PARS] = {"c","d","e","f","j","J","k","K","o","r","s","t","w",
+		"-trace","-trace-min","-serve","-workers"};
 
 
 
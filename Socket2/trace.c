@@ -0,0 +1,122 @@
+/*
+
+					SOCKET
+					 v3.02
+
+					trace.c
+
+
+Description: this C program identifies coiled-coil motifs in a Protein Data Bank
+(Berman et al, Nucleic Acids Res v28 pp235-42, 2000) file. Also required as
+input is a DSSP (Kabsch & Sander, Biopolymers v22 pp 2577-637) file derived from
+the PDB file.
+
+
+*/
+
+/*					trace.c
+					-------
+
+The timeline of a run (--trace <file>), written as Chrome trace-event JSON,
+which opens directly in Perfetto (ui.perfetto.dev) or chrome://tracing. Each
+span is a 'complete' event (ph "X", with a start and a duration in
+microseconds from the start of the run):
+
+	entry		the whole run, named by the PDB code; in a batch of runs,
+			each trace file therefore holds one entry
+
+	stage		each stage of the analysis (see profile.c); these nest
+			within the entry, and the inner stages within the outer
+
+	helix_pair	each pair of helices whose knobs-into-holes search took at
+			least --trace-min microseconds (default 1000), with the
+			helix-keys and the number of residue pairs measured
+
+	coiled_coil	with -j, the register assignment and the writing out of
+			each coiled coil, on the thread which did it (threads
+			1..N; the main thread is 0)
+
+Spans may be written from any thread, so trace_span() holds a lock while it
+writes.
+*/
+
+#include "socket.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+
+static FILE *trace_file;
+static double trace_start;
+static int trace_events = 0;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+void open_trace(char file_name[])
+	{
+	if ((trace_file = fopen(file_name,"w")) == NULL)
+		{
+		if (!setflag[flag_p]) printf("Failed to open trace file \"%s\"\n\n",file_name);
+		exit(1);
+		}
+	if (!setflag[flag_p]) printf("opened \"%s\" (output)\n",file_name);
+
+	if (par[par_trace_min] == NULL) trace_min = 1000.0;
+	else sscanf(par[par_trace_min],"%lf",&trace_min);
+	if (trace_min < 0.0)
+		{
+		printf("--trace-min must not be negative\n\n");
+		exit(1);
+		}
+
+	trace_start = monotonic_seconds();
+	tracing = true;
+	fprintf(trace_file,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	}
+
+
+void trace_span(char name[], char category[], int thread, double start, char args[])
+	{
+	double end;
+
+	end = monotonic_seconds();
+	pthread_mutex_lock(&trace_lock);
+	fprintf(trace_file,"%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+		"\"ts\":%.3f,\"dur\":%.3f",trace_events++ ? ",\n" : "",name,category,thread,
+		(start - trace_start) * 1e6,(end - start) * 1e6);
+	if (args != NULL) fprintf(trace_file,",\"args\":%s",args);
+	fprintf(trace_file,"}");
+	pthread_mutex_unlock(&trace_lock);
+	}
+
+
+void trace_helix_pair(int helix1, int helix2, double start, long residue_pairs)
+	{
+	char name[32], args[96];
+
+	if ((monotonic_seconds() - start) * 1e6 < trace_min) return;
+	sprintf(name,"helices %d,%d",helix1,helix2);
+	sprintf(args,"{\"helix1\":%d,\"helix2\":%d,\"residue_pairs\":%ld}",helix1,helix2,residue_pairs);
+	trace_span(name,"helix_pair",0,start,args);
+	}
+
+
+void close_trace()
+	{
+	int t;
+	char name[MAX_FILE_NAME_LENGTH + 8];
+
+	/* the whole run; the code is a file name, which might need escaping */
+	strcpy(name,"entry ");
+	for (t = 0; code[t] && (strlen(name) < sizeof(name) - 1); t++)
+		if ((code[t] != '"') && (code[t] != '\\') && ((unsigned char) code[t] >= ' '))
+			strncat(name,&code[t],1);
+	trace_span(name,"entry",0,trace_start,NULL);
+
+	/* name the threads */
+	fprintf(trace_file,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main\"}}");
+	for (t = 1; t <= threads; t++)
+		fprintf(trace_file,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"register %d\"}}",t,t);
+	fprintf(trace_file,"\n]}\n");
+	fclose(trace_file);
+	tracing = false;
+	}